@@ -450,7 +450,7 @@ void BaseView::draw()
 		// Draw crafts
 		if ((*i)->getBuildTime() == 0 && (*i)->getRules()->getCrafts() > 0 && craft != _base->getCrafts()->end())
 		{
-			if ((*craft)->getStatus() != "STR_OUT")
+			if ((*craft)->getStatus() != CRAFT_OUT)
 			{
 				Surface *frame = _texture->getFrame((*craft)->getRules()->getSprite() + 33);
 				frame->setX((*i)->getX() * GRID_SIZE + ((*i)->getRules()->getSize() - 1) * GRID_SIZE / 2 + 2);
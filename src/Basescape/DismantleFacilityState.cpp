@@ -102,6 +102,7 @@ void DismantleFacilityState::btnOkClick(Action *action)
 			if (*i == _fac)
 			{
 				_base->getFacilities()->erase(i);
+				_base->updateFacilities();
 				delete _fac;
 				break;
 			}
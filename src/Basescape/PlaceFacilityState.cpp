@@ -154,6 +154,7 @@ void PlaceFacilityState::viewClick(Action *action)
 		BaseFacility *fac = new BaseFacility(_rule, _base, _view->getGridX(), _view->getGridY());
 		fac->setBuildTime(_rule->getBuildTime());
 		_base->getFacilities()->push_back(fac);
+		_base->updateFacilities();
 		_game->getSavedGame()->setFunds(_game->getSavedGame()->getFunds() - _rule->getBuildCost());
 		_game->popState();
 	}
@@ -82,6 +82,7 @@ void PlaceLiftState::viewClick(Action *action)
 	BaseFacility *fac = new BaseFacility(_game->getRuleset()->getBaseFacility("STR_ACCESS_LIFT"), _base, _view->getGridX(), _view->getGridY());
 	fac->setBuildTime(0);
 	_base->getFacilities()->push_back(fac);
+	_base->updateFacilities();
 	_game->popState();
 	_game->pushState(new BasescapeState(_game, _base, _globe));
 }
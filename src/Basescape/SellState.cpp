@@ -138,7 +138,7 @@ SellState::SellState(Game *game, Base *base) : State(game), _base(base), _qtys()
 	}
 	for (std::vector<Craft*>::iterator i = _base->getCrafts()->begin(); i != _base->getCrafts()->end(); ++i)
 	{
-		if ((*i)->getStatus() != "STR_OUT")
+		if ((*i)->getStatus() != CRAFT_OUT)
 		{
 			_qtys.push_back(0);
 			_crafts.push_back(*i);
@@ -242,7 +242,8 @@ void SellState::btnOkClick(Action *action)
 				}
 
 				// Remove items from craft
-				for (std::map<std::string, int>::iterator it = craft->getItems()->getContents()->begin(); it != craft->getItems()->getContents()->end(); ++it)
+				std::map<std::string, int> contents = craft->getItems()->getContents();
+				for (std::map<std::string, int>::iterator it = contents.begin(); it != contents.end(); ++it)
 				{
 					_base->getItems()->addItem(it->first, it->second);
 				}
@@ -25,6 +25,7 @@
 #include "../Savegame/SavedBattleGame.h"
 #include "../Battlescape/TileEngine.h"
 #include "../Battlescape/Pathfinding.h"
+#include "../Battlescape/ThreatMap.h"
 #include "../Engine/RNG.h"
 
 namespace OpenXcom
@@ -119,6 +120,7 @@ void AggroBAIState::think(BattleAction *action)
 {
 	action->type = BA_NONE;
 	action->actor = _unit;
+
 	/* Aggro is mainly either shooting a target or running towards it (melee).
 	   If we do no action here - we assume we lost aggro and will go back to patrol state.
 	*/
@@ -147,7 +149,7 @@ void AggroBAIState::think(BattleAction *action)
 	{
 		// if we see the target, we either can shoot him, or take cover.
 		bool takeCover = true;
-		int number = RNG::generate(0,100);
+		int number = RNG::generate(RNG::STREAM_AI, 0,100);
 
 		// lost health, chances to take cover get bigger
 		if (_unit->getHealth() < _unit->getStats()->health)
@@ -208,7 +210,7 @@ void AggroBAIState::think(BattleAction *action)
 				}
 				else
 				{
-					if (RNG::generate(1,10) < 5)
+					if (RNG::generate(RNG::STREAM_AI, 1,10) < 5)
 						action->type = BA_SNAPSHOT;
 					else
 						action->type = BA_AUTOSHOT;
@@ -224,40 +226,51 @@ void AggroBAIState::think(BattleAction *action)
 
 		if (takeCover)
 		{
-			// the idea is to check within a 5 tile radius for a tile which is not seen by our aggroTarget
-			// if there is no such tile, we run away from the target.
 			action->type = BA_WALK;
-			int tries = 0;
-			bool coverFound = false;
-			while (tries < 30 && !coverFound)
-			{
-				tries++;
-				action->target = _unit->getPosition();
-				action->target.x += RNG::generate(-5,5);
-				action->target.y += RNG::generate(-5,5);
-				if (tries < 20)
-
-					coverFound = !_game->getTileEngine()->visible(_aggroTarget, _game->getTile(action->target));
-				else
-					coverFound = true;
-
-				if (coverFound)
-				{
-					// check if we can reach this tile
-					_game->getPathfinding()->calculate(_unit, action->target);
-					if (_game->getPathfinding()->getStartDirection() == -1)
-					{
-						coverFound = false;
-					}
-					_game->getPathfinding()->abortPath();
-				}
-			}
+			findCover(action);
 		}
 	}
 
 	action->TU = action->actor->getActionTUs(action->type, action->weapon);
 }
 
+/**
+ * Looks for the reachable tile within a 5 tile radius that is the least
+ * exposed to the enemy, according to the threat map. Fewer watchers come
+ * first, then watchers that are further away, then the cheaper walk,
+ * so a unit that is already out of sight stays where it is.
+ * @param action AI action to fill in with the destination.
+ */
+void AggroBAIState::findCover(BattleAction *action)
+{
+	std::vector<Position> positions;
+	std::vector<int> costs;
+	ThreatMap *threatMap = _game->getThreatMap();
+	Position origin = _unit->getPosition();
+	int bestWatchers = -1, bestThreat = 0, bestCost = 0;
+
+	action->target = origin;
+	_game->getPathfinding()->findReachable(_unit, _unit->getTimeUnits(), &positions, &costs);
+	for (size_t i = 0; i < positions.size(); ++i)
+	{
+		if (abs(positions[i].x - origin.x) > 5 || abs(positions[i].y - origin.y) > 5)
+			continue;
+
+		int watchers = threatMap->getWatchers(positions[i], _unit->getFaction());
+		int threat = threatMap->getThreat(positions[i], _unit->getFaction());
+		if (bestWatchers == -1
+			|| watchers < bestWatchers
+			|| (watchers == bestWatchers && threat < bestThreat)
+			|| (watchers == bestWatchers && threat == bestThreat && costs[i] < bestCost))
+		{
+			bestWatchers = watchers;
+			bestThreat = threat;
+			bestCost = costs[i];
+			action->target = positions[i];
+		}
+	}
+}
+
 /**
  * Sets the aggro target to be used by the AI.
  * Note that this does not mean the AI will chase the unit, it will just walk towards this position.
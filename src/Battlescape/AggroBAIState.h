@@ -38,6 +38,7 @@ protected:
 	BattleUnit *_aggroTarget;
 	Position _lastKnownPosition;
 	int _timesNotSeen;
+	void findCover(BattleAction *action);
 public:
 	/// Creates a new AggroBAIState linked to the game and a certain unit.
 	AggroBAIState(SavedBattleGame *game, BattleUnit *unit);
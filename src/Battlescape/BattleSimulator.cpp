@@ -0,0 +1,245 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BattleSimulator.h"
+#include <sstream>
+#include <iomanip>
+#include "BattlescapeState.h"
+#include "BattlescapeGame.h"
+#include "BattlescapeGenerator.h"
+#include "Map.h"
+#include "UnitWalkBState.h"
+#include "UnitTurnBState.h"
+#include "UnitDieBState.h"
+#include "ProjectileFlyBState.h"
+#include "ExplosionBState.h"
+#include "../Engine/Game.h"
+#include "../Engine/Exception.h"
+#include "../Savegame/SavedGame.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/Base.h"
+#include "../Ruleset/XcomRuleset.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Initializes a simulator with no battle.
+ * @param game Pointer to the core game, with the resources already loaded.
+ */
+BattleSimulator::BattleSimulator(Game *game) : _game(game), _state(0), _turns(0), _cycles(0), _ticks(0)
+{
+}
+
+/**
+ * Deletes the battlescape state the battle was played in.
+ */
+BattleSimulator::~BattleSimulator()
+{
+	delete _state;
+}
+
+/**
+ * Loads a saved game containing a battle in progress.
+ * @param filename Filename of the save without extension.
+ */
+void BattleSimulator::load(const std::string &filename)
+{
+	Ruleset *r = new XcomRuleset();
+	SavedGame *s = new SavedGame(DIFF_BEGINNER);
+	_game->setRuleset(r);
+	s->load(filename, r);
+	_game->setSavedGame(s);
+	if (s->getBattleGame() == 0)
+	{
+		throw Exception("Saved game has no battle in progress");
+	}
+	s->getBattleGame()->loadMapResources(_game->getResourcePack());
+}
+
+/**
+ * Generates a terror mission with the starting base's
+ * Skyranger against a sectoid crew, like the debug button
+ * on the Geoscape.
+ */
+void BattleSimulator::generate()
+{
+	_game->setRuleset(new XcomRuleset());
+	_game->setSavedGame(_game->getRuleset()->newSave(DIFF_BEGINNER));
+
+	SavedBattleGame *bgame = new SavedBattleGame();
+	_game->getSavedGame()->setBattleGame(bgame);
+	bgame->setMissionType("STR_TERROR_MISSION");
+	BattlescapeGenerator bgen(_game);
+	bgen.setWorldTexture(1);
+	bgen.setWorldShade(0);
+	bgen.setCraft(_game->getSavedGame()->getBases()->at(0)->getCrafts()->at(0));
+	bgen.setBase(_game->getSavedGame()->getBases()->at(0));
+	bgen.setAlienRace("STR_SECTOID");
+	bgen.setAlienItemlevel(0);
+	bgen.run();
+	bgame->resetUnitTiles();
+}
+
+/**
+ * Sorts a battle state into the subsystem it's timed under.
+ * @param state Pointer to the battle state.
+ * @return Subsystem name.
+ */
+std::string BattleSimulator::getCategory(BattleState *state) const
+{
+	if (state == 0)
+		return "end turn";
+	if (dynamic_cast<UnitWalkBState*>(state))
+		return "walking";
+	if (dynamic_cast<UnitTurnBState*>(state))
+		return "turning";
+	if (dynamic_cast<ProjectileFlyBState*>(state))
+		return "projectiles";
+	if (dynamic_cast<ExplosionBState*>(state))
+		return "explosions";
+	if (dynamic_cast<UnitDieBState*>(state))
+		return "dying";
+	return "other";
+}
+
+/**
+ * Checks if either side has been wiped out.
+ * @return True if the mission is over.
+ */
+bool BattleSimulator::isFinished() const
+{
+	int liveAliens = 0;
+	int liveSoldiers = 0;
+	std::vector<BattleUnit*> *units = _game->getSavedGame()->getBattleGame()->getUnits();
+	for (std::vector<BattleUnit*>::iterator i = units->begin(); i != units->end(); ++i)
+	{
+		if (!(*i)->isOut())
+		{
+			if ((*i)->getFaction() == FACTION_HOSTILE)
+				liveAliens++;
+			if ((*i)->getFaction() == FACTION_PLAYER)
+				liveSoldiers++;
+		}
+	}
+	return liveAliens == 0 || liveSoldiers == 0;
+}
+
+/**
+ * Runs the battle as fast as possible until either side
+ * is wiped out or the turn limit is reached. The AI plays
+ * both sides and every subsystem is timed separately.
+ * @param turns Maximum number of turns to play.
+ */
+void BattleSimulator::run(int turns)
+{
+	SavedBattleGame *save = _game->getSavedGame()->getBattleGame();
+	delete _state;
+	_state = new BattlescapeState(_game);
+	BattlescapeGame *battle = _state->getBattleGame();
+	battle->setHeadless(true);
+	_state->init();
+
+	int firstTurn = save->getTurn();
+	Uint32 start = SDL_GetTicks();
+	_times.clear();
+	_cycles = 0;
+	while (save->getTurn() - firstTurn < turns && !isFinished())
+	{
+		clock_t t = clock();
+		battle->think();
+		_times["AI"] += clock() - t;
+
+		// tiles like UFO doors only move on with the animation timer
+		t = clock();
+		_state->getMap()->animate(false);
+		_times["animation"] += clock() - t;
+
+		if (battle->isBusy())
+		{
+			std::string category = getCategory(battle->getCurrentState());
+			t = clock();
+			battle->handleState();
+			_times[category] += clock() - t;
+		}
+		_cycles++;
+	}
+	_ticks = SDL_GetTicks() - start;
+	_turns = save->getTurn() - firstTurn;
+}
+
+/**
+ * Hashes the position and condition of every unit, so two
+ * runs with the same seed can be checked for divergence.
+ * @return Hexadecimal digest.
+ */
+std::string BattleSimulator::getDigest() const
+{
+	SavedBattleGame *save = _game->getSavedGame()->getBattleGame();
+	unsigned int hash = 2166136261u;
+	std::vector<int> values;
+	values.push_back(save->getTurn());
+	for (std::vector<BattleUnit*>::iterator i = save->getUnits()->begin(); i != save->getUnits()->end(); ++i)
+	{
+		values.push_back((*i)->getId());
+		values.push_back((*i)->getPosition().x);
+		values.push_back((*i)->getPosition().y);
+		values.push_back((*i)->getPosition().z);
+		values.push_back((*i)->getHealth());
+		values.push_back((*i)->getStunlevel());
+		values.push_back((*i)->getTimeUnits());
+		values.push_back((*i)->getStatus());
+	}
+	values.push_back(save->getItems()->size());
+	for (std::vector<int>::iterator i = values.begin(); i != values.end(); ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			hash ^= (*i >> (j * 8)) & 0xFF;
+			hash *= 16777619u;
+		}
+	}
+	std::ostringstream ss;
+	ss << std::hex << std::setw(8) << std::setfill('0') << hash;
+	return ss.str();
+}
+
+/**
+ * Prints the turn rate, the time spent in each subsystem
+ * and the final digest.
+ * @param out Stream to print to.
+ */
+void BattleSimulator::report(std::ostream &out) const
+{
+	double seconds = _ticks / 1000.0;
+	out << "Turns: " << _turns << std::endl;
+	out << "Cycles: " << _cycles << std::endl;
+	out << "Time: " << seconds << " s" << std::endl;
+	if (seconds > 0)
+	{
+		out << "Turns/s: " << _turns / seconds << std::endl;
+	}
+	for (std::map<std::string, clock_t>::const_iterator i = _times.begin(); i != _times.end(); ++i)
+	{
+		out << "  " << std::left << std::setw(12) << i->first << std::right << (double)i->second / CLOCKS_PER_SEC << " s" << std::endl;
+	}
+	out << "Digest: " << getDigest() << std::endl;
+}
+
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_BATTLESIMULATOR_H
+#define OPENXCOM_BATTLESIMULATOR_H
+
+#include <string>
+#include <map>
+#include <ostream>
+#include <ctime>
+#include <SDL.h>
+
+namespace OpenXcom
+{
+
+class Game;
+class BattlescapeState;
+class BattleState;
+
+/**
+ * Plays out a battle without a player at the controls.
+ * The AI handles both sides and nothing is drawn, so the
+ * battlescape logic can be timed and compared between builds.
+ */
+class BattleSimulator
+{
+private:
+	Game *_game;
+	BattlescapeState *_state;
+	std::map<std::string, clock_t> _times;
+	int _turns, _cycles;
+	Uint32 _ticks;
+
+	std::string getCategory(BattleState *state) const;
+	bool isFinished() const;
+public:
+	/// Creates a new battle simulator.
+	BattleSimulator(Game *game);
+	/// Cleans up the battle simulator.
+	~BattleSimulator();
+	/// Loads a battle from a saved game.
+	void load(const std::string &filename);
+	/// Generates a new terror mission.
+	void generate();
+	/// Plays the battle for a number of turns.
+	void run(int turns);
+	/// Gets a checksum of the battle state.
+	std::string getDigest() const;
+	/// Prints the results of the run.
+	void report(std::ostream &out) const;
+};
+
+}
+
+#endif
@@ -73,6 +73,16 @@ void BattleState::think()
 
 }
 
+/**
+ * Checks if nothing this state does is visible to the player,
+ * in which case its animation can be skipped.
+ * @return True if the state can be played out at once.
+ */
+bool BattleState::isUnseen()
+{
+	return false;
+}
+
 /*
  * Get the action result. Returns error messages or an empty string when everything went fine.
  * @return Error or empty when everything is fine.
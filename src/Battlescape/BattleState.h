@@ -48,6 +48,8 @@ public:
 	virtual void cancel();
 	/// Runs state functionality every cycle.
 	virtual void think();
+	/// Checks if the player can't see anything of this state.
+	virtual bool isUnseen();
 	/// Get a copy of the action.
 	BattleAction getAction() const;
 };
@@ -40,6 +40,7 @@
 #include "AggroBAIState.h"
 #include "PatrolBAIState.h"
 #include "Pathfinding.h"
+#include "NodeGraph.h"
 #include "../Engine/Game.h"
 #include "../Engine/Music.h"
 #include "../Engine/Language.h"
@@ -89,6 +90,7 @@ BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parent
 	_tuReserved = BA_NONE;
 	_debugPlay = false;
 	_playerPanicHandled = true;
+	_headless = false;
 	_AIActionCounter = 0;
 	_currentAction.actor = 0;
 
@@ -114,31 +116,41 @@ void BattlescapeGame::think()
 	// nothing is happening - see if we need some alien AI or units panicking or what have you
 	if (_states.empty())
 	{
-		// it's a non player side (ALIENS or CIVILIANS)
-		if (_save->getSide() != FACTION_PLAYER)
+		// it's a non player side (ALIENS or CIVILIANS), or nobody is at the controls
+		if (_save->getSide() != FACTION_PLAYER || _headless)
 		{
 			if (!_debugPlay)
 			{
-				if (_save->getSelectedUnit())
+				// keep deciding until a unit starts doing something, the turn ends or the AI runs out of time,
+				// so units with nothing to do don't cost a whole cycle each
+				UnitFaction side = _save->getSide();
+				int decisions = 0;
+				Uint32 deadline = Timer::getTicks() + Options::getInt("battleAIBudget");
+				do
 				{
-					if (!handlePanickingUnit(_save->getSelectedUnit()))
-						handleAI(_save->getSelectedUnit());
-				}
-				else
-				{
-					if (_save->selectNextPlayerUnit(true) == 0)
+					if (_save->getSelectedUnit())
 					{
-						if (!_save->getDebugMode())
-						{
-							statePushBack(0); // end AI turn
-						}
-						else
+						if (!handlePanickingUnit(_save->getSelectedUnit()))
+							handleAI(_save->getSelectedUnit());
+					}
+					else
+					{
+						if (_save->selectNextPlayerUnit(true) == 0)
 						{
-							_save->selectNextPlayerUnit(false);
-							_debugPlay = true;
+							if (!_save->getDebugMode())
+							{
+								statePushBack(0); // end AI turn
+							}
+							else
+							{
+								_save->selectNextPlayerUnit(false);
+								_debugPlay = true;
+							}
 						}
 					}
+					decisions++;
 				}
+				while (_states.empty() && _save->getSide() == side && !_debugPlay && decisions <= (int)_save->getUnits()->size() && Timer::getTicks() < deadline);
 			}
 		}
 		else
@@ -176,15 +188,15 @@ void BattlescapeGame::handleAI(BattleUnit *unit)
 		ai = unit->getCurrentAIState();
 	}
 
-	_AIActionCounter++;
-
 	AggroBAIState *aggro = dynamic_cast<AggroBAIState*>(ai);
 	
 	BattleAction action;
 	unit->think(&action);
+	_AIActionCounter++;
 	if (action.type == BA_WALK)
 	{
- 		_save->getPathfinding()->calculate(action.actor, action.target);
+		// patrols go from node to node, which the node graph may already know the way for
+		_save->getNodeGraph()->calculate(action.actor, action.target);
 		statePushBack(new UnitWalkBState(this, action));
 	}
 
@@ -331,7 +343,11 @@ void BattlescapeGame::endTurn()
 		}
 	}
 
-	if (_save->getSide() != FACTION_NEUTRAL)
+	if (_headless)
+	{
+		init();
+	}
+	else if (_save->getSide() != FACTION_NEUTRAL)
 	{
 		_parentState->getGame()->pushState(new NextTurnState(_parentState->getGame(), _save, _parentState));
 	}
@@ -384,7 +400,7 @@ void BattlescapeGame::checkForCasualties(BattleItem *murderweapon, BattleUnit *m
 					{
 						int closest = 1000000;
 						BattleUnit *revenger = 0;
-						bool revenge = RNG::generate(0,100) < 50;
+						bool revenge = RNG::generate(RNG::STREAM_COMBAT, 0,100) < 50;
 						for (std::vector<BattleUnit*>::iterator h = _save->getUnits()->begin(); h != _save->getUnits()->end(); ++h)
 						{
 							if ((*h)->getFaction() == FACTION_HOSTILE && !(*h)->isOut() && (*h) != victim)
@@ -465,12 +481,29 @@ void BattlescapeGame::showInfoBoxQueue()
 {
 	for (std::vector<InfoboxOKState*>::iterator i = _infoboxQueue.begin(); i != _infoboxQueue.end(); ++i)
 	{
-		_parentState->getGame()->pushState(*i);
+		pushGameState(*i);
 	}
 
 	_infoboxQueue.clear();
 }
 
+/**
+ * Pushes a popup on top of the battlescape. In headless mode
+ * nobody is there to close it, so it's discarded instead.
+ * @param state Pointer to the popup state.
+ */
+void BattlescapeGame::pushGameState(State *state)
+{
+	if (_headless)
+	{
+		delete state;
+	}
+	else
+	{
+		_parentState->getGame()->pushState(state);
+	}
+}
+
 /**
  * Handles the result of non target actions, like priming a grenade.
  */
@@ -589,9 +622,18 @@ void BattlescapeGame::handleState()
 		}
 		else
 		{
-			_states.front()->think();
+			BattleState *state = _states.front();
+			state->think();
+			// nobody can see what this state is doing, so play it out now instead of one frame per tick
+			for (int i = 0; i < MAX_UNSEEN_STEPS && !_states.empty() && _states.front() == state && (_headless || state->isUnseen()); ++i)
+			{
+				state->think();
+			}
+		}
+		if (!_headless)
+		{
+			getMap()->draw(); // redraw map
 		}
-		getMap()->draw(); // redraw map
 	}
 }
 
@@ -762,7 +804,7 @@ void BattlescapeGame::popState()
 	{
 		std::wstringstream ss;
 		ss << action.actor->getName(_parentState->getGame()->getLanguage()) << L'\n' << _parentState->getGame()->getLanguage()->getString("STR_HAS_BECOME_UNCONSCIOUS");
-		_parentState->getGame()->pushState(new InfoboxState(_parentState->getGame(), ss.str()));
+		pushGameState(new InfoboxState(_parentState->getGame(), ss.str()));
 	}
 	
 
@@ -849,11 +891,11 @@ bool BattlescapeGame::handlePanickingUnit(BattleUnit *unit)
 	// show a little infobox with the name of the unit and "... is panicking"
 	std::wstringstream ss;
 	ss << unit->getName(_parentState->getGame()->getLanguage()) << L'\n' << _parentState->getGame()->getLanguage()->getString(status==STATUS_PANICKING?"STR_HAS_PANICKED":"STR_HAS_GONE_BERSERK");
-	_parentState->getGame()->pushState(new InfoboxState(_parentState->getGame(), ss.str()));
+	pushGameState(new InfoboxState(_parentState->getGame(), ss.str()));
 
 	unit->abortTurn(); //makes the unit go to status STANDING :p
 
-	int flee = RNG::generate(0,100);
+	int flee = RNG::generate(RNG::STREAM_AI, 0,100);
 	switch (status)
 	{
 	case STATUS_PANICKING: // 1/2 chance to freeze and 1/2 chance try to flee
@@ -874,7 +916,7 @@ bool BattlescapeGame::handlePanickingUnit(BattleUnit *unit)
 			unit->setCache(0);
 			BattleAction ba;
 			ba.actor = unit;
-			ba.target = Position(unit->getPosition().x + RNG::generate(-5,5), unit->getPosition().y + RNG::generate(-5,5), unit->getPosition().z);
+			ba.target = Position(unit->getPosition().x + RNG::generate(RNG::STREAM_AI, -5,5), unit->getPosition().y + RNG::generate(RNG::STREAM_AI, -5,5), unit->getPosition().z);
 			if (_save->getTile(ba.target)) // only walk towards it when the place exists
 			{
 				_save->getPathfinding()->calculate(ba.actor, ba.target);
@@ -887,7 +929,7 @@ bool BattlescapeGame::handlePanickingUnit(BattleUnit *unit)
 		for (int i= 0; i < 4; i++)
 		{
 			ba.actor = unit;
-			ba.target = Position(unit->getPosition().x + RNG::generate(-5,5), unit->getPosition().y + RNG::generate(-5,5), unit->getPosition().z);
+			ba.target = Position(unit->getPosition().x + RNG::generate(RNG::STREAM_AI, -5,5), unit->getPosition().y + RNG::generate(RNG::STREAM_AI, -5,5), unit->getPosition().z);
 			statePushBack(new UnitTurnBState(this, ba));
 		}
 		for (std::vector<BattleUnit*>::iterator j = unit->getVisibleUnits()->begin(); j != unit->getVisibleUnits()->end(); ++j)
@@ -990,6 +1032,37 @@ bool BattlescapeGame::isBusy()
 	return !_states.empty();
 }
 
+/**
+ * Gets the state at the front of the queue.
+ * @return Pointer to the battle state, or 0 when idle or ending the turn.
+ */
+BattleState *BattlescapeGame::getCurrentState() const
+{
+	return _states.empty() ? 0 : _states.front();
+}
+
+/**
+ * Switches headless mode, used to run battles without a player:
+ * the map isn't redrawn, popups are discarded and the AI
+ * plays both sides.
+ * @param headless Run headless?
+ */
+void BattlescapeGame::setHeadless(bool headless)
+{
+	_headless = headless;
+	// the AI playing the player's side needs to know where the aliens look
+	_save->getTileEngine()->setHostileViews(headless);
+}
+
+/**
+ * Checks if the battle is running headless.
+ * @return Is it headless?
+ */
+bool BattlescapeGame::isHeadless() const
+{
+	return _headless;
+}
+
 /**
  * Activate primary action (left click)
  * @param pos Position on the map.
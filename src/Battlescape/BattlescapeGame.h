@@ -39,6 +39,7 @@ class TileEngine;
 class Pathfinding;
 class Ruleset;
 class InfoboxOKState;
+class State;
 
 enum BattleActionType { BA_NONE, BA_TURN, BA_WALK, BA_PRIME, BA_THROW, BA_AUTOSHOT, BA_SNAPSHOT, BA_AIMEDSHOT, BA_STUN, BA_HIT, BA_USE, BA_LAUNCH, BA_MINDCONTROL, BA_PANIC };
 
@@ -66,7 +67,7 @@ private:
 	BattlescapeState *_parentState;
 	std::list<BattleState*> _states;
 	BattleActionType _tuReserved;
-	bool _debugPlay, _playerPanicHandled;
+	bool _debugPlay, _playerPanicHandled, _headless;
 	int _AIActionCounter;
 	BattleAction _currentAction;
 
@@ -77,7 +78,9 @@ private:
 	bool noActionsPending(BattleUnit *bu);
 	std::vector<InfoboxOKState*> _infoboxQueue;
 	void showInfoBoxQueue();
+	void pushGameState(State *state);
 public:
+	static const int MAX_UNSEEN_STEPS = 1000;
 	/// Creates the BattlescapeGame state.
 	BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState);
 	/// Cleans up the BattlescapeGame state.
@@ -121,6 +124,12 @@ public:
 	BattleAction *getCurrentAction();
 	/// Is there currently an action going on.
 	bool isBusy();
+	/// Gets the state currently being processed.
+	BattleState *getCurrentState() const;
+	/// Runs the battle without drawing or popups.
+	void setHeadless(bool headless);
+	/// Is the battle running without drawing or popups.
+	bool isHeadless() const;
 	/// Activate primary action (left click)
 	void primaryAction(const Position &pos);
 	/// Activate secondary action (right click)
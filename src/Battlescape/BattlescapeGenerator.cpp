@@ -16,10 +16,10 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <fstream>
 #include <sstream>
 #include "BattlescapeGenerator.h"
 #include "TileEngine.h"
+#include "NodeGraph.h"
 #include "../Savegame/SavedGame.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Savegame/Tile.h"
@@ -51,7 +51,6 @@
 #include "../Resource/XcomResourcePack.h"
 #include "../Engine/Game.h"
 #include "../Engine/Language.h"
-#include "../Engine/CrossPlatform.h"
 #include "PatrolBAIState.h"
 
 namespace OpenXcom
@@ -60,13 +59,15 @@ namespace OpenXcom
 /**
  * Sets up a BattlescapeGenerator.
  * @param game pointer to Game object.
+ * @param save pointer to the battle to fill, the game's current battle if none is given.
  */
-BattlescapeGenerator::BattlescapeGenerator(Game *game) : _game(game)
+BattlescapeGenerator::BattlescapeGenerator(Game *game, SavedBattleGame *save) : _game(game), _thread(0), _error("")
 {
-	_save = _game->getSavedGame()->getBattleGame();
+	_save = save ? save : _game->getSavedGame()->getBattleGame();
 	_res = _game->getResourcePack();
 	_ufo = 0;
 	_craft = 0;
+	_base = 0;
 	_craftInventoryTile = 0;
 }
 
@@ -75,7 +76,7 @@ BattlescapeGenerator::BattlescapeGenerator(Game *game) : _game(game)
  */
 BattlescapeGenerator::~BattlescapeGenerator()
 {
-
+	cancel();
 }
 
 /**
@@ -85,7 +86,6 @@ BattlescapeGenerator::~BattlescapeGenerator()
 void BattlescapeGenerator::setCraft(Craft *craft)
 {
 	_craft = craft;
-	_craft->setInBattlescape(true);
 }
 
 /**
@@ -95,7 +95,6 @@ void BattlescapeGenerator::setCraft(Craft *craft)
 void BattlescapeGenerator::setUfo(Ufo *ufo)
 {
 	_ufo = ufo;
-	_ufo->setInBattlescape(true);
 }
 
 /**
@@ -156,9 +155,83 @@ void BattlescapeGenerator::setBase(Base *base)
  */
 void BattlescapeGenerator::run()
 {
-	AlienDeployment *ruleDeploy = _game->getRuleset()->getDeployment(_ufo?_ufo->getRules()->getType():_save->getMissionType());
+	prepare();
+	generate();
+	finish();
+}
 
-	ruleDeploy->getDimensions(&_width, &_length, &_height);
+/**
+ * Starts filling up the battlescapesavegame in the background, so the
+ * battle can be ready by the time the player decides to go in.
+ * The terrain graphics are still loaded on the calling thread.
+ */
+void BattlescapeGenerator::start()
+{
+	prepare();
+	_thread = SDL_CreateThread(work, this);
+	if (_thread == 0)
+	{
+		// no threads to be had, just do it now
+		generate();
+	}
+}
+
+/**
+ * Background thread: generates the battle, keeping any error
+ * to be thrown on the main thread.
+ * @param generator Pointer to the battlescape generator.
+ * @return Always 0.
+ */
+int BattlescapeGenerator::work(void *generator)
+{
+	BattlescapeGenerator *self = (BattlescapeGenerator*)generator;
+	try
+	{
+		self->generate();
+	}
+	catch (std::exception &e)
+	{
+		self->_error = e.what();
+	}
+	return 0;
+}
+
+/**
+ * Waits for the battle started with start() to be ready and hands it over.
+ */
+void BattlescapeGenerator::wait()
+{
+	cancel();
+	if (!_error.empty())
+	{
+		throw Exception(_error);
+	}
+	finish();
+}
+
+/**
+ * Waits for the background generation to stop without handing over
+ * the battle, so the craft and UFO are left as they were.
+ */
+void BattlescapeGenerator::cancel()
+{
+	if (_thread != 0)
+	{
+		SDL_WaitThread(_thread, 0);
+		_thread = 0;
+	}
+}
+
+/**
+ * Picks the terrain and loads its graphics, along with the ones for
+ * the craft and the UFO. Anything touching surfaces is done here,
+ * as it has to happen on the main thread.
+ */
+void BattlescapeGenerator::prepare()
+{
+	_deployment = _game->getRuleset()->getDeployment(_ufo?_ufo->getRules()->getType():_save->getMissionType());
+
+	_deployment->getDimensions(&_width, &_length, &_height);
 
 	_unitSequence = BattleUnit::MAX_SOLDIER_ID; // geoscape soldier IDs should stay below this number
 
@@ -225,6 +298,31 @@ void BattlescapeGenerator::run()
 		}
 	}
 
+	std::vector<MapDataSet*> dataSets = *_terrain->getMapDataSets();
+	if (_ufo != 0)
+	{
+		std::vector<MapDataSet*> *ufoSets = _ufo->getRules()->getBattlescapeTerrainData()->getMapDataSets();
+		dataSets.insert(dataSets.end(), ufoSets->begin(), ufoSets->end());
+	}
+	if (_craft != 0)
+	{
+		std::vector<MapDataSet*> *craftSets = _craft->getRules()->getBattlescapeTerrainData()->getMapDataSets();
+		dataSets.insert(dataSets.end(), craftSets->begin(), craftSets->end());
+	}
+	for (std::vector<MapDataSet*>::iterator i = dataSets.begin(); i != dataSets.end(); ++i)
+	{
+		(*i)->loadData();
+	}
+}
+
+/**
+ * Generates the map, the units and items on it and the lighting.
+ * This only works on the battle's own data and the rulesets, and only
+ * draws from the map generation and combat random streams, so it can
+ * run on a separate thread while the geoscape stays untouched.
+ */
+void BattlescapeGenerator::generate()
+{
 	// creates the tile objects
 	_save->initMap(_width, _length, _height);
 	_save->initUtilities(_res);
@@ -280,20 +378,20 @@ void BattlescapeGenerator::run()
 		if (_craft != 0)
 		{
 			// add items that are in the craft
-			for (std::map<std::string, int>::iterator i = _craft->getItems()->getContents()->begin(); i != _craft->getItems()->getContents()->end(); ++i)
+			std::map<std::string, int> contents = _craft->getItems()->getContents();
+			for (std::map<std::string, int>::iterator i = contents.begin(); i != contents.end(); ++i)
 			{
 				for (int count=0; count < (*i).second; count++)
 				{
 					addItem(_game->getRuleset()->getItem((*i).first))->setXCOMProperty(true);
 				}
 			}
-			// inventory of craft is now cleared
-			_craft->getItems()->getContents()->clear();
 		}
 		else
 		{
 			// add items that are in the base
-			for (std::map<std::string, int>::iterator i = _base->getItems()->getContents()->begin(); i != _base->getItems()->getContents()->end(); ++i)
+			std::map<std::string, int> contents = _base->getItems()->getContents();
+			for (std::map<std::string, int>::iterator i = contents.begin(); i != contents.end(); ++i)
 			{
 				// only put items in the battlescape that make sense (when the item got a sprite, it's probably ok)
 				if (_game->getRuleset()->getItem((*i).first)->getBigSprite() > -1)
@@ -306,19 +404,13 @@ void BattlescapeGenerator::run()
 
 	}
 
-	deployAliens(_game->getRuleset()->getAlienRace(_alienRace), ruleDeploy);
+	deployAliens(_game->getRuleset()->getAlienRace(_alienRace), _deployment);
 
 	if (_save->getMissionType() ==  "STR_TERROR_MISSION")
 	{
 		deployCivilians(16);
 	}
 
-
-	if (_save->getMissionType() ==  "STR_UFO_CRASH_RECOVERY")
-	{
-		explodePowerSources();
-	}
-
 	if (_save->getMissionType() == "STR_BASE_DEFENCE")
 	{
 		for (int i = 0; i < _save->getWidth() * _save->getLength() * _save->getHeight(); ++i)
@@ -336,6 +428,34 @@ void BattlescapeGenerator::run()
 	_save->getTileEngine()->calculateUnitLighting();
 }
 
+/**
+ * Blows up the power sources of a crashed UFO, then marks the craft and
+ * UFO as being in battle, and empties the craft now that its items are
+ * on the battlescape. The explosions are done here because fire and smoke
+ * pick their animation from the cosmetic random stream, which the main
+ * thread keeps drawing from while the battle is generated.
+ */
+void BattlescapeGenerator::finish()
+{
+	if (_save->getMissionType() ==  "STR_UFO_CRASH_RECOVERY")
+	{
+		explodePowerSources();
+		_save->getTileEngine()->calculateSunShading();
+		_save->getTileEngine()->calculateTerrainLighting();
+		_save->getTileEngine()->calculateUnitLighting();
+	}
+	if (_ufo != 0)
+	{
+		_ufo->setInBattlescape(true);
+	}
+	if (_craft != 0)
+	{
+		_craft->setInBattlescape(true);
+		// inventory of craft is now cleared
+		_craft->getItems()->clear();
+	}
+}
+
 /**
  * Adds a soldier to the game and place him on a free spawnpoint.
  * Spawnpoints are either tiles in case of an xcom craft that landed.
@@ -353,7 +473,7 @@ BattleUnit *BattlescapeGenerator::addXCOMUnit(BattleUnit *unit)
 		{
 			_save->setUnitPosition(unit, node->getPosition());
 		}
-		unit->setDirection(RNG::generate(0,7));
+		unit->setDirection(RNG::generate(RNG::STREAM_MAPGEN, 0,7));
 	}
 	else
 	{
@@ -387,10 +507,10 @@ void BattlescapeGenerator::deployAliens(AlienRace *race, AlienDeployment *deploy
 	{
 		std::string alienName = race->getMember((*d).alienRank);
 		// TODO: make this depend on difficulty level
-		int quantity = (*d).lowQty + RNG::generate(0, (*d).dQty);
+		int quantity = (*d).lowQty + RNG::generate(RNG::STREAM_MAPGEN, 0, (*d).dQty);
 		for (int i = 0; i < quantity; i++)
 		{
-			bool outside = RNG::generate(0,99) < (*d).percentageOutsideUfo;
+			bool outside = RNG::generate(RNG::STREAM_MAPGEN, 0,99) < (*d).percentageOutsideUfo;
 			if (_ufo == 0)
 				outside = false;
 			BattleUnit *unit = addAlien(_game->getRuleset()->getUnit(alienName), (*d).alienRank, outside);
@@ -452,8 +572,8 @@ BattleUnit *BattlescapeGenerator::addAlien(Unit *rules, int alienRank, bool outs
 	if (node)
 	{
 		_save->setUnitPosition(unit, node->getPosition());
-		unit->setAIState(new PatrolBAIState(_game->getSavedGame()->getBattleGame(), unit, node));
-		unit->setDirection(RNG::generate(0,7));
+		unit->setAIState(new PatrolBAIState(_save, unit, node));
+		unit->setDirection(RNG::generate(RNG::STREAM_MAPGEN, 0,7));
 	}
 
 
@@ -475,8 +595,8 @@ BattleUnit *BattlescapeGenerator::addCivilian(Unit *rules)
 	if (node)
 	{
 		_save->setUnitPosition(unit, node->getPosition());
-		unit->setAIState(new PatrolBAIState(_game->getSavedGame()->getBattleGame(), unit, node));
-		unit->setDirection(RNG::generate(0,7));
+		unit->setAIState(new PatrolBAIState(_save, unit, node));
+		unit->setDirection(RNG::generate(RNG::STREAM_MAPGEN, 0,7));
 	}
 
 	_save->getUnits()->push_back(unit);
@@ -694,8 +814,8 @@ void BattlescapeGenerator::generateMap()
 		// pick a random ufo mapblock, can have all kinds of sizes
 		ufoMap = _ufo->getRules()->getBattlescapeTerrainData()->getRandomMapBlock(999, MT_DEFAULT);
 
-		ufoX = RNG::generate(0, (_length / 10) - ufoMap->getWidth() / 10);
-		ufoY = RNG::generate(0, (_width / 10) - ufoMap->getLength() / 10);
+		ufoX = RNG::generate(RNG::STREAM_MAPGEN, 0, (_length / 10) - ufoMap->getWidth() / 10);
+		ufoY = RNG::generate(RNG::STREAM_MAPGEN, 0, (_width / 10) - ufoMap->getLength() / 10);
 
 		for (int i = 0; i < ufoMap->getWidth() / 10; ++i)
 		{
@@ -713,8 +833,8 @@ void BattlescapeGenerator::generateMap()
 		craftMap = _craft->getRules()->getBattlescapeTerrainData()->getRandomMapBlock(999, MT_DEFAULT);
 		while (!placed)
 		{
-			craftX = RNG::generate(0, (_length/10)- craftMap->getWidth() / 10);
-			craftY = RNG::generate(0, (_width/10)- craftMap->getLength() / 10);
+			craftX = RNG::generate(RNG::STREAM_MAPGEN, 0, (_length/10)- craftMap->getWidth() / 10);
+			craftY = RNG::generate(RNG::STREAM_MAPGEN, 0, (_width/10)- craftMap->getLength() / 10);
 			placed = true;
 			// check if this place is ok
 			for (int i = 0; i < craftMap->getWidth() / 10; ++i)
@@ -740,16 +860,16 @@ void BattlescapeGenerator::generateMap()
 	/* determine positioning of the urban terrain roads */
 	if (_save->getMissionType() == "STR_TERROR_MISSION")
 	{
-		bool EWRoad = RNG::generate(0,99) < 33;
+		bool EWRoad = RNG::generate(RNG::STREAM_MAPGEN, 0,99) < 33;
 		bool NSRoad = !EWRoad;
-		bool TwoRoads = RNG::generate(0,99) < 25;
+		bool TwoRoads = RNG::generate(RNG::STREAM_MAPGEN, 0,99) < 25;
 		int roadX = craftX;
 		int roadY = craftY;
 		// make sure the road(s) are not crossing the craftin landing site
 		while (roadX == craftX || roadY == craftY)
 		{
-			roadX = RNG::generate(0, (_length/10)- 1);
-			roadY = RNG::generate(0, (_width/10)- 1);
+			roadX = RNG::generate(RNG::STREAM_MAPGEN, 0, (_length/10)- 1);
+			roadY = RNG::generate(RNG::STREAM_MAPGEN, 0, (_width/10)- 1);
 		}
 		if (TwoRoads)
 		{
@@ -1056,12 +1176,15 @@ void BattlescapeGenerator::generateMap()
 		}
 	}
 
+	_save->getNodeGraph()->build();
+
 	delete dummy;
 }
 
 
 /**
- * Loads a X-Com format MAP file into the tiles of the battlegame.
+ * Copies a X-Com format MAP block into the tiles of the battlegame.
+ * The MAP file itself is read only once, the MapBlock keeps it in memory.
  * @param mapblock Pointer to MapBlock.
  * @param xoff Mapblock offset in X direction.
  * @param yoff Mapblock offset in Y direction.
@@ -1076,23 +1199,13 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 {
 	int width, length, height;
 	int x = xoff, y = yoff, z = 0;
-	char size[3];
-	unsigned char value[4];
-	std::stringstream filename;
-	filename << "MAPS/" << mapblock->getName() << ".MAP";
 	int terrainObjectID;
 
-	// Load file
-	std::ifstream mapFile (CrossPlatform::getDataFile(filename.str()).c_str(), std::ios::in| std::ios::binary);
-	if (!mapFile)
-	{
-		throw Exception("Failed to load MAP");
-	}
-
-	mapFile.read((char*)&size, sizeof(size));
-	length = (int)size[0];
-	width = (int)size[1];
-	height = (int)size[2];
+	// the file is only read the first time, after that the block comes from memory
+	mapblock->loadData();
+	length = mapblock->getMapLength();
+	width = mapblock->getMapWidth();
+	height = mapblock->getHeight();
 
 	if (height > _save->getHeight())
 	{
@@ -1100,7 +1213,6 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 	}
 
 	z += height - 1;
-	mapblock->setHeight(height);
 
 	for (int i = _height-1; i >0; i--)
 	{
@@ -1118,26 +1230,28 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 		throw Exception("Something is wrong in your map definitions");
 	}
 
-	while (mapFile.read((char*)&value, sizeof(value)))
+	const std::vector<unsigned char> &data = mapblock->getMapData();
+	for (size_t i = 0; i < data.size(); i += MapBlock::MAP_RECORD)
 	{
+		Tile *tile = _save->getTile(Position(x, y, z));
 		for (int part = 0; part < 4; part++)
 		{
-			terrainObjectID = (int)((unsigned char)value[part]);
+			terrainObjectID = (int)data[i + part];
 			if (terrainObjectID>0)
 			{
 				int mapDataSetID = mapDataSetOffset;
 				int mapDataID = terrainObjectID;
 				MapData *md = terrain->getMapData(&mapDataID, &mapDataSetID);
-				_save->getTile(Position(x, y, z))->setMapData(md, mapDataID, mapDataSetID, part);
+				tile->setMapData(md, mapDataID, mapDataSetID, part);
 			}
 			// if the part is empty and it's not a floor, remove it
 			// it prevents growing grass in UFOs
 			if (terrainObjectID == 0 && part > 0)
 			{
-				_save->getTile(Position(x, y, z))->setMapData(0, -1, -1, part);
+				tile->setMapData(0, -1, -1, part);
 			}
 		}
-		_save->getTile(Position(x, y, z))->setDiscovered(discovered, 2);
+		tile->setDiscovered(discovered, 2);
 
 		x++;
 
@@ -1153,18 +1267,12 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 		}
 	}
 
-	if (!mapFile.eof())
-	{
-		throw Exception("Invalid data from file");
-	}
-
-	mapFile.close();
-
 	return height;
 }
 
 /**
- * Loads a X-Com format RMP file into the spawnpoints of the battlegame.
+ * Loads a X-Com format RMP block into the spawnpoints of the battlegame.
+ * The RMP file itself is read only once, the MapBlock keeps it in memory.
  * @param mapblock pointer to MapBlock.
  * @param xoff mapblock offset in X direction
  * @param yoff mapblock offset in Y direction
@@ -1173,22 +1281,19 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
  */
 void BattlescapeGenerator::loadRMP(MapBlock *mapblock, int xoff, int yoff, int segment)
 {
-	int id = 0;
-	char value[24];
-	std::stringstream filename;
-	filename << "ROUTES/" << mapblock->getName() << ".RMP";
-
-	// Load file
-	std::ifstream mapFile (CrossPlatform::getDataFile(filename.str()).c_str(), std::ios::in| std::ios::binary);
-	if (!mapFile)
+	mapblock->loadData();
+	if (!mapblock->hasRoutes())
 	{
 		throw Exception("Failed to load RMP");
 	}
 
+	const std::vector<unsigned char> &data = mapblock->getRouteData();
 	size_t nodeOffset = _save->getNodes()->size();
+	int id = 0;
 
-	while (mapFile.read((char*)&value, sizeof(value)))
+	for (size_t i = 0; i < data.size(); i += MapBlock::RMP_RECORD)
 	{
+		const char *value = (const char*)&data[i];
 		Node *node = new Node(nodeOffset + id, Position(xoff + (int)value[1], yoff + (int)value[0], mapblock->getHeight() - 1 - (int)value[2]), segment, (int)value[19], (int)value[20], (int)value[21], (int)value[22], (int)value[23]);
 		for (int j=0;j<5;++j)
 		{
@@ -1202,13 +1307,6 @@ void BattlescapeGenerator::loadRMP(MapBlock *mapblock, int xoff, int yoff, int s
 		_save->getNodes()->push_back(node);
 		id++;
 	}
-
-	if (!mapFile.eof())
-	{
-		throw Exception("Invalid data from file");
-	}
-
-	mapFile.close();
 }
 
 /**
@@ -1218,13 +1316,13 @@ void BattlescapeGenerator::explodePowerSources()
 {
 	for (int i = 0; i < _save->getWidth() * _save->getLength() * _save->getHeight(); ++i)
 	{
-		if (_save->getTiles()[i]->getMapData(MapData::O_OBJECT) && _save->getTiles()[i]->getMapData(MapData::O_OBJECT)->getSpecialType() == UFO_POWER_SOURCE && RNG::generate(0,100) < 75)
+		if (_save->getTiles()[i]->getMapData(MapData::O_OBJECT) && _save->getTiles()[i]->getMapData(MapData::O_OBJECT)->getSpecialType() == UFO_POWER_SOURCE && RNG::generate(RNG::STREAM_MAPGEN, 0,100) < 75)
 		{
 			Position pos;
 			pos.x = _save->getTiles()[i]->getPosition().x*16;
 			pos.y = _save->getTiles()[i]->getPosition().y*16;
 			pos.z = (_save->getTiles()[i]->getPosition().z*24) +12;
-			_save->getTileEngine()->explode(pos, 180+RNG::generate(0,70), DT_HE, 11);
+			_save->getTileEngine()->explode(pos, 180+RNG::generate(RNG::STREAM_MAPGEN, 0,70), DT_HE, 11);
 		}
 	}
 }
@@ -1234,11 +1332,11 @@ void BattlescapeGenerator::explodePowerSources()
  */
 void BattlescapeGenerator::deployCivilians(int max)
 {
-	int number = RNG::generate(1, max);
+	int number = RNG::generate(RNG::STREAM_MAPGEN, 1, max);
 
 	for (int i = 0; i < number; ++i)
 	{
-		if (RNG::generate(0,100) < 50)
+		if (RNG::generate(RNG::STREAM_MAPGEN, 0,100) < 50)
 		{
 			addCivilian(_game->getRuleset()->getUnit("MALE_CIVILIAN"));
 		}
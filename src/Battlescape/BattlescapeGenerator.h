@@ -19,6 +19,8 @@
 #ifndef OPENXCOM_BATTLESCAPEGENERATOR_H
 #define OPENXCOM_BATTLESCAPEGENERATOR_H
 
+#include <string>
+#include <SDL.h>
 #include "../Savegame/Node.h"
 #include "../Savegame/SavedBattleGame.h"
 
@@ -59,6 +61,18 @@ private:
 	Tile *_craftInventoryTile;
 	std::string _alienRace;
 	int _alienItemLevel;
+	AlienDeployment *_deployment;
+	SDL_Thread *_thread;
+	std::string _error;
+
+	/// Background thread running the generation.
+	static int work(void *generator);
+	/// Picks the terrain and loads its graphics.
+	void prepare();
+	/// Generates the battle data.
+	void generate();
+	/// Hands the battle over to the geoscape objects.
+	void finish();
 
 	/// Generate a new battlescape map.
 	void generateMap();
@@ -82,7 +96,7 @@ private:
 	void deployCivilians(int max);
 public:
 	/// Creates a new BattlescapeGenerator class
-	BattlescapeGenerator(Game *game);
+	BattlescapeGenerator(Game *game, SavedBattleGame *save = 0);
 	/// Cleans up the BattlescapeGenerator.
 	~BattlescapeGenerator();
 	/// Sets the xcom craft.
@@ -101,6 +115,12 @@ public:
 	void setBase(Base *base);
 	/// Runs the generator.
 	void run();
+	/// Starts running the generator in the background.
+	void start();
+	/// Waits for the background generator and hands the battle over.
+	void wait();
+	/// Waits for the background generator and drops the battle.
+	void cancel();
 
 };
 
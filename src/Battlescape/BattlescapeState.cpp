@@ -39,6 +39,7 @@
 #include "Pathfinding.h"
 #include "BattlescapeGame.h"
 #include "../Engine/Game.h"
+#include "../Engine/FrameScheduler.h"
 #include "../Engine/Music.h"
 #include "../Engine/Language.h"
 #include "../Engine/Font.h"
@@ -372,6 +373,11 @@ void BattlescapeState::think()
 	{
 		if (_popups.empty())
 		{
+			// The AI thinks every cycle, not just on timers
+			if (_save->getSide() != FACTION_PLAYER)
+			{
+				_game->getFrameScheduler()->setBusy();
+			}
 			State::think();
 			_battleGame->think();
 			_animTimer->think(this, 0);
@@ -915,6 +921,15 @@ Map *BattlescapeState::getMap() const
 	return _map;
 }
 
+/**
+ * Get pointer to the battle game engine running on this screen.
+ * @return Pointer to battle game.
+ */
+BattlescapeGame *BattlescapeState::getBattleGame() const
+{
+	return _battleGame;
+}
+
 /**
  * Show a debug message in the topleft corner.
  * @param message Debug message.
@@ -148,6 +148,8 @@ public:
 	Game *getGame() const;
 	/// Get map.
 	Map *getMap() const;
+	/// Get battle game.
+	BattlescapeGame *getBattleGame() const;
 	/// Show debug message.
 	void debug(const std::wstring message);
 	/// Show warning message.
@@ -76,7 +76,7 @@ void ExplosionBState::init()
 			{
 				Position p = _center;
 				p.x += i; p.y += j;
-				Explosion *explosion = new Explosion(p, RNG::generate(0,6), true);
+				Explosion *explosion = new Explosion(p, RNG::generate(RNG::STREAM_COSMETIC, 0,6), true);
 				// add the explosion on the map
 				_parent->getMap()->getExplosions()->insert(explosion);
 			}
@@ -0,0 +1,310 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <queue>
+#include <functional>
+#include <cstdlib>
+#include "NodeGraph.h"
+#include "Pathfinding.h"
+#include "TileEngine.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/Node.h"
+#include "../Savegame/NodeLink.h"
+#include "../Savegame/Tile.h"
+#include "../Ruleset/Armor.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Sets up an empty node graph, build() fills it once the nodes are known.
+ * @param save Pointer to the battle save.
+ */
+NodeGraph::NodeGraph(SavedBattleGame *save) : _save(save), _size(0), _blocksX(0), _blocksY(0)
+{
+
+}
+
+/**
+ * Deletes the node graph.
+ */
+NodeGraph::~NodeGraph()
+{
+
+}
+
+/**
+ * Indexes the nodes and works out the cheapest way between every pair
+ * of nodes along their links, with a search from each node. Links cost
+ * the distance between the nodes they connect, plus one per level.
+ * Has to be called again whenever the nodes or their links change.
+ */
+void NodeGraph::build()
+{
+	std::vector<Node*> *nodes = _save->getNodes();
+	_size = nodes->size();
+	_blocksX = (_save->getWidth() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	_blocksY = (_save->getLength() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+	_nodeAt.clear();
+	_blocks.assign(_blocksX * _blocksY, std::vector<Node*>());
+	_ranks.clear();
+	_targets.clear();
+	_routes.clear();
+
+	for (std::vector<Node*>::iterator i = nodes->begin(); i != nodes->end(); ++i)
+	{
+		const Position &pos = (*i)->getPosition();
+		_nodeAt[_save->getTileIndex(pos)] = *i;
+		if (pos.x >= 0 && pos.x < _save->getWidth() && pos.y >= 0 && pos.y < _save->getLength())
+		{
+			_blocks[(pos.y / BLOCK_SIZE) * _blocksX + pos.x / BLOCK_SIZE].push_back(*i);
+		}
+		int rank = (*i)->getRank();
+		if (rank >= 0)
+		{
+			if (rank >= (int)_ranks.size())
+				_ranks.resize(rank + 1);
+			_ranks[rank].push_back(*i);
+		}
+		if ((*i)->isTarget())
+		{
+			_targets.push_back(*i);
+		}
+	}
+
+	// the node links make a sparse graph, so a search from every node is a lot cheaper than going over all triples
+	_cost.assign(_size * _size, -1);
+	_next.assign(_size * _size, -1);
+	for (int from = 0; from < _size; ++from)
+	{
+		std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int> >, std::greater<std::pair<int, int> > > open;
+		int *cost = &_cost[from * _size];
+		int *next = &_next[from * _size];
+		cost[from] = 0;
+		next[from] = from;
+		open.push(std::make_pair(0, from));
+		while (!open.empty())
+		{
+			int current = open.top().second;
+			int currentCost = open.top().first;
+			open.pop();
+			if (currentCost > cost[current])
+				continue;
+
+			Node *node = nodes->at(current);
+			for (int i = 0; i < 5; ++i)
+			{
+				int link = node->getNodeLink(i)->getConnectedNodeID();
+				if (link < 0 || link >= _size)
+					continue;
+
+				const Position &a = node->getPosition(), &b = nodes->at(link)->getPosition();
+				int total = currentCost + _save->getTileEngine()->distance(a, b) + abs(a.z - b.z);
+				if (cost[link] == -1 || total < cost[link])
+				{
+					cost[link] = total;
+					next[link] = (current == from) ? link : next[current];
+					open.push(std::make_pair(total, link));
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Gets the node at a position.
+ * @param pos Position on the map.
+ * @return pointer to the node, 0 if there is no node there.
+ */
+Node *NodeGraph::getNode(const Position &pos) const
+{
+	std::map<int, Node*>::const_iterator i = _nodeAt.find(_save->getTileIndex(pos));
+	if (i == _nodeAt.end())
+		return 0;
+	return i->second;
+}
+
+/**
+ * Gets the node closest to a position. The map blocks are searched in
+ * rings around the position, and the search stops as soon as no block
+ * further out can hold anything closer.
+ * @param pos Position on the map.
+ * @return pointer to the closest node, 0 if there are no nodes.
+ */
+Node *NodeGraph::getClosestNode(const Position &pos) const
+{
+	Node *closest = 0;
+	int closestDistance = 1000000;
+	int blockX = pos.x / BLOCK_SIZE, blockY = pos.y / BLOCK_SIZE;
+	int rings = std::max(_blocksX, _blocksY);
+
+	for (int ring = 0; ring <= rings; ++ring)
+	{
+		for (int y = blockY - ring; y <= blockY + ring; ++y)
+		{
+			for (int x = blockX - ring; x <= blockX + ring; ++x)
+			{
+				// only the blocks on the edge of the ring are new
+				if (x < 0 || x >= _blocksX || y < 0 || y >= _blocksY
+					|| (abs(x - blockX) != ring && abs(y - blockY) != ring))
+					continue;
+
+				const std::vector<Node*> &block = _blocks[y * _blocksX + x];
+				for (std::vector<Node*>::const_iterator i = block.begin(); i != block.end(); ++i)
+				{
+					int d = _save->getTileEngine()->distance(pos, (*i)->getPosition());
+					if (d < closestDistance || (d == closestDistance && (*i)->getID() < closest->getID()))
+					{
+						closest = *i;
+						closestDistance = d;
+					}
+				}
+			}
+		}
+		// anything in the next ring is at least this far away
+		if (closest && closestDistance <= ring * BLOCK_SIZE)
+			break;
+	}
+	return closest;
+}
+
+/**
+ * Gets the nodes of a certain rank.
+ * @param rank Node rank.
+ * @return reference to the list of nodes.
+ */
+const std::vector<Node*> &NodeGraph::getNodes(int rank) const
+{
+	if (rank < 0 || rank >= (int)_ranks.size())
+		return _empty;
+	return _ranks[rank];
+}
+
+/**
+ * Gets the nodes that are targets for aliens in base defence missions.
+ * @return reference to the list of nodes.
+ */
+const std::vector<Node*> &NodeGraph::getTargetNodes() const
+{
+	return _targets;
+}
+
+/**
+ * Gets the cost of the cheapest way from one node to another along the node links.
+ * @param from Pointer to the start node.
+ * @param to Pointer to the destination node.
+ * @return cost, -1 if there is no way.
+ */
+int NodeGraph::getRouteCost(Node *from, Node *to) const
+{
+	if (from->getID() >= _size || to->getID() >= _size)
+		return -1;
+	return _cost[from->getID() * _size + to->getID()];
+}
+
+/**
+ * Gets the node to walk to first when going from one node to another.
+ * @param from Pointer to the start node.
+ * @param to Pointer to the destination node.
+ * @return pointer to the next node, 0 if there is no way.
+ */
+Node *NodeGraph::getNextNode(Node *from, Node *to) const
+{
+	if (from->getID() >= _size || to->getID() >= _size)
+		return 0;
+	int next = _next[from->getID() * _size + to->getID()];
+	if (next == -1)
+		return 0;
+	return _save->getNodes()->at(next);
+}
+
+/**
+ * Gets the number of parts destroyed on the tiles of a route. As this
+ * number never goes down, a route is still good as long as it is the
+ * same as when the route was found.
+ * @param route Reference to the route.
+ * @return number of destroyed parts.
+ */
+int NodeGraph::countDestroyed(const Route &route) const
+{
+	int destroyed = 0;
+	for (std::vector<int>::const_iterator i = route.tiles.begin(); i != route.tiles.end(); ++i)
+	{
+		destroyed += _save->getTiles()[*i]->getDestroyed();
+	}
+	return destroyed;
+}
+
+/**
+ * Prepares the pathfinding for a unit walking to a position. When the
+ * unit goes from one node to another, the path found the last time a
+ * unit of the same kind went there is reused, unless terrain along
+ * it was destroyed since or something is standing in the way.
+ * Otherwise the path is calculated as usual, and remembered.
+ * @param unit Pointer to the unit.
+ * @param endPosition Position to walk to.
+ */
+void NodeGraph::calculate(BattleUnit *unit, const Position &endPosition)
+{
+	Pathfinding *pf = _save->getPathfinding();
+	Node *from = getNode(unit->getPosition());
+	Node *to = getNode(endPosition);
+
+	if (from == 0 || to == 0 || from == to)
+	{
+		pf->calculate(unit, endPosition);
+		return;
+	}
+
+	std::pair<int, int> key(from->getID() * _size + to->getID(), unit->getArmor()->getMovementType() * 16 + unit->getArmor()->getSize());
+	std::map<std::pair<int, int>, Route>::iterator i = _routes.find(key);
+	if (i != _routes.end())
+	{
+		if (countDestroyed(i->second) == i->second.destroyed)
+		{
+			if (pf->setPath(unit, i->second.path))
+				return;
+		}
+		else
+		{
+			_routes.erase(i);
+		}
+	}
+
+	pf->calculate(unit, endPosition);
+	if (pf->getPath().empty())
+		return;
+
+	Route route;
+	route.path = pf->getPath();
+	Position pos = unit->getPosition(), nextPos;
+	route.tiles.push_back(_save->getTileIndex(pos));
+	for (std::vector<int>::const_reverse_iterator j = route.path.rbegin(); j != route.path.rend(); ++j)
+	{
+		pf->getTUCost(pos, *j, &nextPos, unit);
+		pos = nextPos;
+		route.tiles.push_back(_save->getTileIndex(pos));
+	}
+	route.destroyed = countDestroyed(route);
+	_routes[key] = route;
+}
+
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_NODEGRAPH_H
+#define OPENXCOM_NODEGRAPH_H
+
+#include <vector>
+#include <map>
+#include "Position.h"
+
+namespace OpenXcom
+{
+
+class SavedBattleGame;
+class BattleUnit;
+class Node;
+
+/**
+ * Indexes the route nodes of the battlescape, so the AI doesn't have to
+ * scan them all: by position, by rank and by whether they are targets.
+ * It also knows the cheapest way between any two nodes along the node
+ * links, and remembers the paths walked between nodes so a patrolling
+ * unit doesn't have to search for them again every turn.
+ */
+class NodeGraph
+{
+private:
+	/// A path walked from one node to another, and the tiles it goes over.
+	struct Route
+	{
+		std::vector<int> path;
+		std::vector<int> tiles;
+		int destroyed;
+	};
+	static const int BLOCK_SIZE = 10;
+	SavedBattleGame *_save;
+	int _size, _blocksX, _blocksY;
+	std::map<int, Node*> _nodeAt;
+	std::vector<std::vector<Node*> > _blocks, _ranks;
+	std::vector<Node*> _targets, _empty;
+	std::vector<int> _cost, _next;
+	std::map<std::pair<int, int>, Route> _routes;
+	/// Gets the number of destroyed parts along a route.
+	int countDestroyed(const Route &route) const;
+public:
+	/// Creates an empty node graph.
+	NodeGraph(SavedBattleGame *save);
+	/// Cleans up the node graph.
+	~NodeGraph();
+	/// Builds the indexes and route costs from the battlescape's nodes.
+	void build();
+	/// Gets the node at a position.
+	Node *getNode(const Position &pos) const;
+	/// Gets the node closest to a position.
+	Node *getClosestNode(const Position &pos) const;
+	/// Gets the nodes of a certain rank.
+	const std::vector<Node*> &getNodes(int rank) const;
+	/// Gets the target nodes.
+	const std::vector<Node*> &getTargetNodes() const;
+	/// Gets the cost of going from one node to another.
+	int getRouteCost(Node *from, Node *to) const;
+	/// Gets the first node on the way from one node to another.
+	Node *getNextNode(Node *from, Node *to) const;
+	/// Prepares the path for a unit, reusing a remembered route if possible.
+	void calculate(BattleUnit *unit, const Position &endPosition);
+};
+
+}
+
+#endif
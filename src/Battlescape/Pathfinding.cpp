@@ -165,6 +165,62 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition)
 
 }
 
+/**
+ * Finds every tile a unit can reach with the given time units, in a single
+ * pass over the map - for when the destination is yet to be chosen.
+ * It spreads out the same way calculate() does, only without a target.
+ * @param unit Pointer to the unit.
+ * @param tuMax Time units the unit may spend.
+ * @param positions Pointer to a list to fill with the reachable positions.
+ * @param costs Pointer to a list to fill with the TU cost of reaching each of them.
+ */
+void Pathfinding::findReachable(BattleUnit *unit, int tuMax, std::vector<Position> *positions, std::vector<int> *costs)
+{
+	std::list<PathfindingNode*> openList;
+	PathfindingNode *currentNode, *nextNode;
+	Position nextPos;
+	int tuCost, totalTuCost;
+
+	_movementType = unit->getArmor()->getMovementType();
+	_unit = unit;
+
+	for (int i = 0; i < _size; ++i)
+		_nodes[i]->reset();
+
+	openList.push_back(getNode(unit->getPosition()));
+	openList.front()->check(0, 0, 0, 0);
+
+	while (!openList.empty())
+	{
+		currentNode = openList.front();
+		for (int direction = 0; direction < 10; direction++)
+		{
+			tuCost = getTUCost(currentNode->getPosition(), direction, &nextPos, unit);
+			if (tuCost < 255)
+			{
+				nextNode = getNode(nextPos);
+				totalTuCost = currentNode->getTUCost() + tuCost;
+				if (totalTuCost <= tuMax && (!nextNode->isChecked() || nextNode->getTUCost() > totalTuCost))
+				{
+					nextNode->check(totalTuCost, currentNode->getStepsNum() + 1, currentNode, direction);
+					openList.push_back(nextNode);
+				}
+			}
+		}
+		openList.pop_front();
+	}
+
+	for (int i = 0; i < _size; ++i)
+	{
+		// units that can't fly don't get to stop in mid-air
+		if (_nodes[i]->isChecked() && (_movementType == MT_FLY || !canFallDown(_save->getTile(_nodes[i]->getPosition()))))
+		{
+			positions->push_back(_nodes[i]->getPosition());
+			costs->push_back(_nodes[i]->getTUCost());
+		}
+	}
+}
+
 /**
  * Get's the TU cost to move from 1 tile to the other(ONE STEP ONLY). But also updates the endPosition, because it is possible
  * the unit goes upstairs or falls down while walking.
@@ -343,6 +399,43 @@ void Pathfinding::abortPath()
 	_path.clear();
 }
 
+/**
+ * Gets the current path. Like the path itself the directions are stored
+ * in reverse order, the first step being the last element.
+ * @return reference to the list of directions.
+ */
+const std::vector<int> &Pathfinding::getPath() const
+{
+	return _path;
+}
+
+/**
+ * Takes over a path that was calculated earlier, so it doesn't have to be
+ * searched again. Every step is checked first: if something now stands in
+ * the way, the path is refused and a new one has to be calculated.
+ * @param unit Pointer to the unit that will walk the path.
+ * @param path List of directions, in the same reverse order as getPath().
+ * @return true if the path can be walked and is now the current path.
+ */
+bool Pathfinding::setPath(BattleUnit *unit, const std::vector<int> &path)
+{
+	Position currentPos = unit->getPosition(), nextPos;
+
+	_movementType = unit->getArmor()->getMovementType();
+	_unit = unit;
+	_path.clear();
+
+	for (std::vector<int>::const_reverse_iterator i = path.rbegin(); i != path.rend(); ++i)
+	{
+		if (getTUCost(currentPos, *i, &nextPos, unit) >= 255)
+			return false;
+		currentPos = nextPos;
+	}
+
+	_path = path;
+	return true;
+}
+
 
 /*
  * Whether a certain part of a tile blocks movement.
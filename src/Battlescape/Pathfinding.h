@@ -61,6 +61,8 @@ public:
 	~Pathfinding();
 	/// Calculate the shortest path.
 	void calculate(BattleUnit *unit, Position endPosition);
+	/// Finds every tile a unit can reach.
+	void findReachable(BattleUnit *unit, int tuMax, std::vector<Position> *positions, std::vector<int> *costs);
 	/// Converts direction to a vector.
 	static void directionToVector(const int direction, Position *vector);
 	/// Check whether a path is ready gives the first direction.
@@ -69,6 +71,10 @@ public:
 	int dequeuePath();
 	/// Get's the TU cost to move from 1 tile to the other.
 	int getTUCost(const Position &startPosition, const int direction, Position *endPosition, BattleUnit *unit);
+	/// Gets the current path, last step first.
+	const std::vector<int> &getPath() const;
+	/// Takes over a path found earlier, if it can still be walked.
+	bool setPath(BattleUnit *unit, const std::vector<int> &path);
 	/// Abort the current path.
 	void abortPath();
 	bool validateUpDown(BattleUnit *bu, Position startPosition, const int direction);
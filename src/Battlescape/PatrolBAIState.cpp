@@ -20,6 +20,7 @@
 #include <cmath>
 #include "PatrolBAIState.h"
 #include "TileEngine.h"
+#include "NodeGraph.h"
 #include "AggroBAIState.h"
 #include "../Savegame/BattleUnit.h"
 #include "../Savegame/SavedBattleGame.h"
@@ -34,7 +35,7 @@ namespace OpenXcom
 /**
  * Sets up a PatrolBAIState.
  */
-PatrolBAIState::PatrolBAIState(SavedBattleGame *game, BattleUnit *unit, Node *node) : BattleAIState(game, unit), _fromNode(node), _toNode(0)
+PatrolBAIState::PatrolBAIState(SavedBattleGame *game, BattleUnit *unit, Node *node) : BattleAIState(game, unit), _fromNode(node), _toNode(0), _targetNode(0)
 {
 
 }
@@ -64,6 +65,15 @@ void PatrolBAIState::load(const YAML::Node &node)
 	{
 		_toNode = _game->getNodes()->at(tonodeID);
 	}
+	if (const YAML::Node *pTarget = node.FindValue("targetnode"))
+	{
+		int targetnodeID;
+		*pTarget >> targetnodeID;
+		if (targetnodeID != -1)
+		{
+			_targetNode = _game->getNodes()->at(targetnodeID);
+		}
+	}
 }
 
 /**
@@ -90,6 +100,10 @@ void PatrolBAIState::save(YAML::Emitter &out) const
 	{
 		out << YAML::Key << "tonode" << YAML::Value << -1;
 	}
+	if (_targetNode)
+	{
+		out << YAML::Key << "targetnode" << YAML::Value << _targetNode->getID();
+	}
 	out << YAML::EndMap;
 }
 
@@ -107,7 +121,9 @@ void PatrolBAIState::enter()
  */
 void PatrolBAIState::exit()
 {
-	if (_toNode) _toNode->free();
+	// on the way to a target, only the target itself is reserved
+	if (_targetNode) _targetNode->free();
+	else if (_toNode) _toNode->free();
 }
 
 /**
@@ -131,24 +147,22 @@ void PatrolBAIState::think(BattleAction *action)
 	{
 		// destination reached
 		_fromNode = _toNode;
-		_toNode->free();
+		if (_targetNode == 0)
+		{
+			_toNode->free();
+		}
+		else if (_targetNode == _toNode)
+		{
+			_targetNode->free();
+			_targetNode = 0;
+		}
 		_toNode = 0;
 	}
 
 	if (_fromNode == 0)
 	{
 		// assume closest node as "from node"
-		int closest = 1000000;
-		for (std::vector<Node*>::iterator i = _game->getNodes()->begin(); i != _game->getNodes()->end(); ++i)
-		{
-			node = *i;
-			int d = _game->getTileEngine()->distance(_unit->getPosition(), node->getPosition());
-			if (d < closest)
-			{
-				_fromNode = node;
-				closest = d;
-			}
-		}
+		_fromNode = _game->getNodeGraph()->getClosestNode(_unit->getPosition());
 	}
 
 	if (_toNode == 0)
@@ -199,20 +213,41 @@ void PatrolBAIState::think(BattleAction *action)
 			}
 			else
 			{
-				// find closest target which is not already allocated
-				int closest = 1000000;
-				for (std::vector<Node*>::iterator i = _game->getNodes()->begin(); i != _game->getNodes()->end(); ++i)
+				NodeGraph *graph = _game->getNodeGraph();
+				if (_targetNode == 0)
 				{
-					if ((*i)->isTarget() && !(*i)->isAllocated())
+					// find closest target which is not already allocated, going along the node links if we can
+					const std::vector<Node*> &targets = graph->getTargetNodes();
+					int closest = 1000000;
+					bool linked = false;
+					for (std::vector<Node*>::const_iterator i = targets.begin(); i != targets.end(); ++i)
 					{
-						node = *i;
-						int d = _game->getTileEngine()->distance(_unit->getPosition(), node->getPosition());
-						if (d < closest)
+						if (!(*i)->isAllocated())
 						{
-							_toNode = node;
-							closest = d;
+							node = *i;
+							int cost = graph->getRouteCost(_fromNode, node);
+							int d = (cost == -1) ? _game->getTileEngine()->distance(_unit->getPosition(), node->getPosition()) : cost;
+							if ((cost != -1 && !linked) || ((cost != -1) == linked && d < closest))
+							{
+								_targetNode = node;
+								closest = d;
+								linked = (cost != -1);
+							}
 						}
 					}
+					if (_targetNode)
+					{
+						_targetNode->allocate();
+					}
+				}
+				if (_targetNode)
+				{
+					// walk there one node at a time, so every leg is a known route
+					_toNode = graph->getNextNode(_fromNode, _targetNode);
+					if (_toNode == 0)
+					{
+						_toNode = _targetNode;
+					}
 				}
 			}
 		}
@@ -225,7 +260,10 @@ void PatrolBAIState::think(BattleAction *action)
 
 	if (_toNode != 0)
 	{
-		_toNode->allocate();
+		if (_targetNode == 0)
+		{
+			_toNode->allocate();
+		}
 		action->actor = _unit;
 		action->type = BA_WALK;
 		action->target = _toNode->getPosition();
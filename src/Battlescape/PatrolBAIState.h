@@ -35,7 +35,7 @@ class Node;
 class PatrolBAIState : public BattleAIState
 {
 protected:
-	Node *_fromNode, *_toNode;
+	Node *_fromNode, *_toNode, *_targetNode;
 public:
 	/// Creates a new BattleAIState linked to the game and a certain unit.
 	PatrolBAIState(SavedBattleGame *game, BattleUnit *unit, Node *node);
@@ -309,6 +309,31 @@ void ProjectileFlyBState::think()
 	}
 }
 
+/*
+ * Checks if the player can't see the shooter or the projectile, so
+ * the flight can be skipped. The projectile is checked on every step,
+ * so the animation resumes once it flies into view.
+ * @return True if the shot is out of sight.
+ */
+bool ProjectileFlyBState::isUnseen()
+{
+	if (_unit->getVisible() || _parent->getSave()->getDebugMode())
+	{
+		return false;
+	}
+	Projectile *projectile = _parent->getMap()->getProjectile();
+	if (projectile)
+	{
+		Position p = projectile->getPosition(0);
+		Tile *t = _parent->getSave()->getTile(Position(p.x/16, p.y/16, p.z/24));
+		if (t && t->getVisible())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 /*
  * Flying projectiles cannot be cancelled.
  */
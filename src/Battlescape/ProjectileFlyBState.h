@@ -52,6 +52,8 @@ public:
 	void cancel();
 	/// Runs state functionality every cycle.
 	void think();
+	/// Checks if the player can't see the shot.
+	bool isUnseen();
 	static bool validThrowRange(BattleAction *action);
 	bool validMeleeRange(BattleAction *action);
 };
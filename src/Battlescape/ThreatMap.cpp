@@ -0,0 +1,143 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ThreatMap.h"
+#include "TileEngine.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/Tile.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Sets up an empty threat map the size of the battlescape.
+ * @param save Pointer to the battle save.
+ */
+ThreatMap::ThreatMap(SavedBattleGame *save) : _save(save), _views()
+{
+	int size = _save->getWidth() * _save->getLength() * _save->getHeight();
+	for (int i = 0; i < 3; ++i)
+	{
+		_watchers[i].resize(size, 0);
+		_threat[i].resize(size, 0);
+	}
+}
+
+/**
+ * Deletes the threat map.
+ */
+ThreatMap::~ThreatMap()
+{
+
+}
+
+/**
+ * Checks whether units of a faction would shoot at units of another.
+ * Aliens are at war with everyone else, civilians are no danger to anyone.
+ * @param watcher Faction of the watching units.
+ * @param target Faction of the watched units.
+ * @return True if the watchers are a danger.
+ */
+bool ThreatMap::isEnemy(UnitFaction watcher, UnitFaction target)
+{
+	return watcher != FACTION_NEUTRAL && (watcher == FACTION_HOSTILE) != (target == FACTION_HOSTILE);
+}
+
+/**
+ * Adds the tiles a unit can see to its faction's map. The closer
+ * the tile, the more it weighs. What is added is remembered along with
+ * the faction, so it can be taken out again even after the unit has
+ * moved or changed sides.
+ * @param unit Pointer to the watching unit.
+ * @param tiles Tiles in the unit's line of sight.
+ */
+void ThreatMap::addWatcher(BattleUnit *unit, const std::vector<Tile*> &tiles)
+{
+	removeWatcher(unit);
+	if (tiles.empty())
+		return;
+
+	int faction = unit->getFaction();
+	_views[unit].first = faction;
+	std::vector<std::pair<int, int> > &view = _views[unit].second;
+	for (std::vector<Tile*>::const_iterator i = tiles.begin(); i != tiles.end(); ++i)
+	{
+		int index = _save->getTileIndex((*i)->getPosition());
+		int weight = TileEngine::MAX_VIEW_DISTANCE + 1 - _save->getTileEngine()->distance(unit->getPosition(), (*i)->getPosition());
+		_watchers[faction][index]++;
+		_threat[faction][index] += weight;
+		view.push_back(std::make_pair(index, weight));
+	}
+}
+
+/**
+ * Takes the tiles a unit was last seeing out of the map of the
+ * faction it was in at the time.
+ * @param unit Pointer to the watching unit.
+ */
+void ThreatMap::removeWatcher(BattleUnit *unit)
+{
+	std::map<BattleUnit*, std::pair<int, std::vector<std::pair<int, int> > > >::iterator view = _views.find(unit);
+	if (view == _views.end())
+		return;
+
+	int faction = view->second.first;
+	for (std::vector<std::pair<int, int> >::iterator i = view->second.second.begin(); i != view->second.second.end(); ++i)
+	{
+		_watchers[faction][i->first]--;
+		_threat[faction][i->first] -= i->second;
+	}
+	_views.erase(view);
+}
+
+/**
+ * Gets how many enemies of a faction can see a tile.
+ * @param pos Position of the tile.
+ * @param faction Faction that wants to stand there.
+ * @return Number of enemy units watching.
+ */
+int ThreatMap::getWatchers(const Position &pos, UnitFaction faction) const
+{
+	int index = _save->getTileIndex(pos), total = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		if (isEnemy((UnitFaction)i, faction))
+			total += _watchers[i][index];
+	}
+	return total;
+}
+
+/**
+ * Gets the threat a tile is under for a faction: every enemy that
+ * can see the tile adds more the closer it stands.
+ * @param pos Position of the tile.
+ * @param faction Faction that wants to stand there.
+ * @return Threat value, 0 if no enemy sees the tile.
+ */
+int ThreatMap::getThreat(const Position &pos, UnitFaction faction) const
+{
+	int index = _save->getTileIndex(pos), total = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		if (isEnemy((UnitFaction)i, faction))
+			total += _threat[i][index];
+	}
+	return total;
+}
+
+}
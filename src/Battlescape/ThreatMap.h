@@ -0,0 +1,65 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_THREATMAP_H
+#define OPENXCOM_THREATMAP_H
+
+#include <vector>
+#include <map>
+#include "Position.h"
+#include "../Savegame/BattleUnit.h"
+
+namespace OpenXcom
+{
+
+class SavedBattleGame;
+class Tile;
+
+/**
+ * Keeps track of how exposed every tile of the battlescape is.
+ * For each tile it counts the units of each faction that can see it,
+ * weighted by how close they are. It is built from the field of view
+ * calculations and kept up to date whenever a unit's view changes,
+ * so the AI can judge a tile without tracing any lines itself.
+ */
+class ThreatMap
+{
+private:
+	SavedBattleGame *_save;
+	std::vector<int> _watchers[3], _threat[3];
+	std::map<BattleUnit*, std::pair<int, std::vector<std::pair<int, int> > > > _views;
+	/// Checks whether units of a faction are a danger to another faction.
+	static bool isEnemy(UnitFaction watcher, UnitFaction target);
+public:
+	/// Creates a new threat map for the battlescape.
+	ThreatMap(SavedBattleGame *save);
+	/// Cleans up the threat map.
+	~ThreatMap();
+	/// Adds the tiles a unit currently sees.
+	void addWatcher(BattleUnit *unit, const std::vector<Tile*> &tiles);
+	/// Removes the tiles a unit was last seeing.
+	void removeWatcher(BattleUnit *unit);
+	/// Gets the number of enemies watching a tile.
+	int getWatchers(const Position &pos, UnitFaction faction) const;
+	/// Gets the threat a tile is under.
+	int getThreat(const Position &pos, UnitFaction faction) const;
+};
+
+}
+
+#endif
@@ -23,11 +23,13 @@
 #include <SDL.h>
 #include "BattleAIState.h"
 #include "AggroBAIState.h"
+#include "ThreatMap.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Savegame/Tile.h"
 #include "../Savegame/BattleUnit.h"
 #include "../Savegame/Soldier.h"
 #include "../Engine/RNG.h"
+#include "../Engine/JobSystem.h"
 #include "../Ruleset/MapDataSet.h"
 #include "../Ruleset/MapData.h"
 #include "../Ruleset/Unit.h"
@@ -38,11 +40,167 @@
 namespace OpenXcom
 {
 
+/// Number of tiles handed out at once in map-wide passes.
+static const int TILE_GRAIN = 1024;
+
+/**
+ * Resets the ambient light of a range of tiles and shades them from the sun.
+ */
+class SunShadingTask : public ParallelTask
+{
+private:
+	TileEngine *_engine;
+	Tile **_tiles;
+public:
+	SunShadingTask(TileEngine *engine, Tile **tiles) : _engine(engine), _tiles(tiles) {}
+	void run(int, int begin, int end)
+	{
+		for (int i = begin; i < end; ++i)
+		{
+			_tiles[i]->resetLight(0);
+			_engine->calculateSunShading(_tiles[i]);
+		}
+	}
+};
+
+/**
+ * Resets the static light of a range of tiles and collects
+ * the light sources in it: lit terrain, fires and flares.
+ */
+class LightSourceTask : public ParallelTask
+{
+private:
+	Tile **_tiles;
+	std::vector<std::vector<std::pair<Position, int> > > _sources;
+public:
+	LightSourceTask(Tile **tiles, int chunks) : _tiles(tiles), _sources(chunks) {}
+	void run(int chunk, int begin, int end)
+	{
+		const int layer = 1; // Static lighting layer.
+		const int fireLightPower = 15; // amount of light a fire generates
+		std::vector<std::pair<Position, int> > &sources = _sources[chunk];
+		for (int i = begin; i < end; ++i)
+		{
+			Tile *tile = _tiles[i];
+			tile->resetLight(layer);
+			// only floors and objects can light up
+			if (tile->getMapData(MapData::O_FLOOR) && tile->getMapData(MapData::O_FLOOR)->getLightSource())
+			{
+				sources.push_back(std::make_pair(tile->getPosition(), tile->getMapData(MapData::O_FLOOR)->getLightSource()));
+			}
+			if (tile->getMapData(MapData::O_OBJECT) && tile->getMapData(MapData::O_OBJECT)->getLightSource())
+			{
+				sources.push_back(std::make_pair(tile->getPosition(), tile->getMapData(MapData::O_OBJECT)->getLightSource()));
+			}
+			// fires
+			if (tile->getFire())
+			{
+				sources.push_back(std::make_pair(tile->getPosition(), fireLightPower));
+			}
+			for (std::vector<BattleItem*>::iterator it = tile->getInventory()->begin(); it != tile->getInventory()->end(); ++it)
+			{
+				if ((*it)->getRules()->getBattleType() == BT_FLARE)
+				{
+					sources.push_back(std::make_pair(tile->getPosition(), (*it)->getRules()->getPower()));
+				}
+			}
+		}
+	}
+	/// Gets all the light sources in tile order.
+	void getSources(std::vector<std::pair<Position, int> > *sources) const
+	{
+		for (std::vector<std::vector<std::pair<Position, int> > >::const_iterator i = _sources.begin(); i != _sources.end(); ++i)
+		{
+			sources->insert(sources->end(), i->begin(), i->end());
+		}
+	}
+};
+
+/**
+ * Spreads a list of light sources over a range of map levels.
+ * Every level only touches its own tiles and a tile keeps
+ * the brightest light it gets, so the order doesn't matter.
+ */
+class LightSpreadTask : public ParallelTask
+{
+private:
+	TileEngine *_engine;
+	const std::vector<std::pair<Position, int> > &_sources;
+	int _layer;
+public:
+	LightSpreadTask(TileEngine *engine, const std::vector<std::pair<Position, int> > &sources, int layer) : _engine(engine), _sources(sources), _layer(layer) {}
+	void run(int, int begin, int end)
+	{
+		for (std::vector<std::pair<Position, int> >::const_iterator i = _sources.begin(); i != _sources.end(); ++i)
+		{
+			_engine->addLight(i->first, i->second, _layer, begin, end);
+		}
+	}
+};
+
+/**
+ * Looks for the first explosive tile in a range.
+ */
+class ExplosiveTileTask : public ParallelTask
+{
+private:
+	Tile **_tiles;
+	std::vector<int> _found;
+public:
+	ExplosiveTileTask(Tile **tiles, int chunks) : _tiles(tiles), _found(chunks, -1) {}
+	void run(int chunk, int begin, int end)
+	{
+		for (int i = begin; i < end; ++i)
+		{
+			if (_tiles[i]->getExplosive())
+			{
+				_found[chunk] = i;
+				return;
+			}
+		}
+	}
+	/// Gets the first explosive tile on the map.
+	Tile *getFound() const
+	{
+		for (std::vector<int>::const_iterator i = _found.begin(); i != _found.end(); ++i)
+		{
+			if (*i != -1)
+				return _tiles[*i];
+		}
+		return 0;
+	}
+};
+
+/**
+ * Works out what a list of units can see, storing it per unit.
+ */
+class VisibilityTask : public ParallelTask
+{
+private:
+	TileEngine *_engine;
+	const std::vector<BattleUnit*> &_watchers;
+	std::vector<std::vector<BattleUnit*> > _units;
+	std::vector<std::vector<Tile*> > _tiles;
+public:
+	VisibilityTask(TileEngine *engine, const std::vector<BattleUnit*> &watchers) : _engine(engine), _watchers(watchers), _units(watchers.size()), _tiles(watchers.size()) {}
+	void run(int, int begin, int end)
+	{
+		for (int i = begin; i < end; ++i)
+		{
+			_engine->findVisible(_watchers[i], &_units[i], &_tiles[i]);
+		}
+	}
+	/// Gets the units seen by a watcher.
+	const std::vector<BattleUnit*> &getUnits(int i) const { return _units[i]; }
+	/// Gets the tiles seen by a watcher.
+	const std::vector<Tile*> &getTiles(int i) const { return _tiles[i]; }
+};
+
 /**
  * Sets up a TileEngine.
  * @param save pointer to SavedBattleGame object.
  */
-TileEngine::TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData) : _save(save), _voxelData(voxelData), _personalLighting(true)
+TileEngine::TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData) : _save(save), _voxelData(voxelData), _personalLighting(true), _hostileViews(false)
 {
 
 }
@@ -61,13 +219,8 @@ TileEngine::~TileEngine()
   */
 void TileEngine::calculateSunShading()
 {
-	const int layer = 0; // Ambient lighting layer.
-
-	for (int i = 0; i < _save->getWidth() * _save->getLength() * _save->getHeight(); ++i)
-	{
-		_save->getTiles()[i]->resetLight(layer);
-		calculateSunShading(_save->getTiles()[i]);
-	}
+	SunShadingTask task(this, _save->getTiles());
+	JobSystem::parallelFor(0, _save->getWidth() * _save->getLength() * _save->getHeight(), TILE_GRAIN, &task);
 }
 
 /**
@@ -98,45 +251,18 @@ void TileEngine::calculateSunShading(Tile *tile)
 void TileEngine::calculateTerrainLighting()
 {
 	const int layer = 1; // Static lighting layer.
-	const int fireLightPower = 15; // amount of light a fire generates
+	const int size = _save->getWidth() * _save->getLength() * _save->getHeight();
 
-	// reset all light to 0 first
-	for (int i = 0; i < _save->getWidth() * _save->getLength() * _save->getHeight(); ++i)
-	{
-		_save->getTiles()[i]->resetLight(layer);
-	}
+	// reset all light to 0 first, and find what lights up the terrain: objects, fires and flares
+	LightSourceTask sources(_save->getTiles(), JobSystem::getChunks(0, size, TILE_GRAIN));
+	JobSystem::parallelFor(0, size, TILE_GRAIN, &sources);
 
-	// add lighting of terrain
-	for (int i = 0; i < _save->getWidth() * _save->getLength() * _save->getHeight(); ++i)
-	{
-		// only floors and objects can light up
-		if (_save->getTiles()[i]->getMapData(MapData::O_FLOOR)
-			&& _save->getTiles()[i]->getMapData(MapData::O_FLOOR)->getLightSource())
-		{
-			addLight(_save->getTiles()[i]->getPosition(), _save->getTiles()[i]->getMapData(MapData::O_FLOOR)->getLightSource(), layer);
-		}
-		if (_save->getTiles()[i]->getMapData(MapData::O_OBJECT)
-			&& _save->getTiles()[i]->getMapData(MapData::O_OBJECT)->getLightSource())
-		{
-			addLight(_save->getTiles()[i]->getPosition(), _save->getTiles()[i]->getMapData(MapData::O_OBJECT)->getLightSource(), layer);
-		}
-
-		// fires
-		if (_save->getTiles()[i]->getFire())
-		{
-			addLight(_save->getTiles()[i]->getPosition(), fireLightPower, layer);
-		}
-
-		for (std::vector<BattleItem*>::iterator it = _save->getTiles()[i]->getInventory()->begin(); it != _save->getTiles()[i]->getInventory()->end(); ++it)
-		{
-			if ((*it)->getRules()->getBattleType() == BT_FLARE)
-			{
-				addLight(_save->getTiles()[i]->getPosition(), (*it)->getRules()->getPower(), layer);
-			}
-		}
-
-	}
+	std::vector<std::pair<Position, int> > lights;
+	sources.getSources(&lights);
 
+	// then spread the light, one level at a time
+	LightSpreadTask spread(this, lights, layer);
+	JobSystem::parallelFor(0, _save->getHeight(), 1, &spread);
 }
 
 /**
@@ -173,13 +299,26 @@ void TileEngine::calculateUnitLighting()
  * @param layer Light is seperated in 3 layers: Ambient, Static and Dynamic.
  */
 void TileEngine::addLight(const Position &center, int power, int layer)
+{
+	addLight(center, power, layer, 0, _save->getHeight());
+}
+
+/**
+ * Adds circular light pattern starting from center, only on some levels of the map.
+ * @param center
+ * @param power
+ * @param layer Light is seperated in 3 layers: Ambient, Static and Dynamic.
+ * @param zBegin First level to light up.
+ * @param zEnd Level after the last one to light up.
+ */
+void TileEngine::addLight(const Position &center, int power, int layer, int zBegin, int zEnd)
 {
 	// only loop through the positive quadrant.
 	for (int x = 0; x <= power; ++x)
 	{
 		for (int y = 0; y <= power; ++y)
 		{
-			for (int z = 0; z < _save->getHeight(); z++)
+			for (int z = zBegin; z < zEnd; z++)
 			{
 				int distance = int(floor(sqrt(float(x*x + y*y)) + 0.5));
 
@@ -207,7 +346,36 @@ void TileEngine::addLight(const Position &center, int power, int layer)
  */
 bool TileEngine::calculateFOV(BattleUnit *unit)
 {
-	size_t visibleUnitsChecksum = 0, oldNumVisibleUnits = 0;
+	std::vector<BattleUnit*> units;
+	std::vector<Tile*> tiles;
+	findVisible(unit, &units, &tiles);
+	return applyFOV(unit, units, tiles);
+}
+
+/**
+ * Calculates line of sight of several soldiers. The looking around is
+ * shared out between threads, then the results are applied in order.
+ * @param units The watchers.
+ */
+void TileEngine::calculateFOV(const std::vector<BattleUnit*> &units)
+{
+	VisibilityTask task(this, units);
+	JobSystem::parallelFor(0, units.size(), 1, &task);
+	for (size_t i = 0; i < units.size(); ++i)
+	{
+		applyFOV(units[i], task.getUnits(i), task.getTiles(i));
+	}
+}
+
+/**
+ * Finds what a soldier can see from where he stands. Doesn't change
+ * the unit or the map, so it's safe to run for several units at once.
+ * @param unit The watcher.
+ * @param units Units in sight, in the order they were seen.
+ * @param tiles Tiles in sight (only for player units, and aliens if their views are traced).
+ */
+void TileEngine::findVisible(BattleUnit *unit, std::vector<BattleUnit*> *units, std::vector<Tile*> *tiles)
+{
 	Position center = unit->getPosition();
 	Position test;
 	bool swap = (unit->getDirection()==0 || unit->getDirection()==4);
@@ -215,18 +383,8 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 	int signY[8] = { -1, -1, -1, +1, +1, +1, -1, -1 };
 	int y1, y2;
 
-	// calculate a visible units checksum - if it changed during this step, the soldier stops walking
-	// the unit's Xposition * 100 + y seems a simple but unique ID for each unit
-	for (std::vector<BattleUnit*>::iterator i = unit->getVisibleUnits()->begin(); i != unit->getVisibleUnits()->end(); ++i)
-		visibleUnitsChecksum += (*i)->getPosition().x*100 + (*i)->getPosition().y;
-
-	oldNumVisibleUnits = unit->getVisibleUnits()->size();
-
-	unit->clearVisibleUnits();
-	unit->clearVisibleTiles();
-
 	if (unit->isOut())
-		return false;
+		return;
 
 	for (int x = 0; x <= MAX_VIEW_DISTANCE; ++x)
 	{
@@ -255,35 +413,75 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 						BattleUnit *visibleUnit = _save->getTile(test)->getUnit();
 						if (visibleUnit && !visibleUnit->isOut() && visible(unit, _save->getTile(test)))
 						{
-							if ((visibleUnit->getFaction() == FACTION_HOSTILE && unit->getFaction() != FACTION_HOSTILE)
-								|| (visibleUnit->getFaction() != FACTION_HOSTILE && unit->getFaction() == FACTION_HOSTILE))
-							{
-								unit->addToVisibleUnits(visibleUnit);
-							}
-							if (unit->getFaction() == FACTION_PLAYER)
-								visibleUnit->setVisible(true);
+							units->push_back(visibleUnit);
 						}
 
-						if (unit->getFaction() == FACTION_PLAYER)
+						// tiles in LOS - tile visibility is not calculated in voxelspace but in tilespace
+						if ((unit->getFaction() == FACTION_PLAYER || (unit->getFaction() == FACTION_HOSTILE && _hostileViews)) && calculateLine(unit->getPosition(), test, false, 0, unit, false) <= 0)
 						{
-							// this sets tiles to discovered if they are in LOS - tile visibility is not calculated in voxelspace but in tilespace
-							if (calculateLine(unit->getPosition(), test, false, 0, unit, false) <= 0)
-							{
-								unit->addToVisibleTiles(_save->getTile(test));
-								_save->getTile(test)->setDiscovered(true, 2);
-								_save->getTile(test)->setVisible(+1);
-								// walls to the east or south of a visible tile, we see that too
-								Tile* t = _save->getTile(Position(test.x + 1, test.y, test.z));
-								if (t) t->setDiscovered(true, 0);
-								t = _save->getTile(Position(test.x, test.y + 1, test.z));
-								if (t) t->setDiscovered(true, 1);
-							}
+							tiles->push_back(_save->getTile(test));
 						}
 					}
 				}
 			}
 		}
 	}
+}
+
+/**
+ * Updates a soldier's line of sight and the map with what he sees.
+ * @param unit The watcher.
+ * @param units Units in sight.
+ * @param tiles Tiles in sight.
+ * @return true when new aliens spotted
+ */
+bool TileEngine::applyFOV(BattleUnit *unit, const std::vector<BattleUnit*> &units, const std::vector<Tile*> &tiles)
+{
+	size_t visibleUnitsChecksum = 0, oldNumVisibleUnits = 0;
+
+	// calculate a visible units checksum - if it changed during this step, the soldier stops walking
+	// the unit's Xposition * 100 + y seems a simple but unique ID for each unit
+	for (std::vector<BattleUnit*>::iterator i = unit->getVisibleUnits()->begin(); i != unit->getVisibleUnits()->end(); ++i)
+		visibleUnitsChecksum += (*i)->getPosition().x*100 + (*i)->getPosition().y;
+
+	oldNumVisibleUnits = unit->getVisibleUnits()->size();
+
+	unit->clearVisibleUnits();
+	unit->clearVisibleTiles();
+	_save->getThreatMap()->removeWatcher(unit);
+
+	if (unit->isOut())
+		return false;
+
+	for (std::vector<BattleUnit*>::const_iterator i = units.begin(); i != units.end(); ++i)
+	{
+		if (((*i)->getFaction() == FACTION_HOSTILE && unit->getFaction() != FACTION_HOSTILE)
+			|| ((*i)->getFaction() != FACTION_HOSTILE && unit->getFaction() == FACTION_HOSTILE))
+		{
+			unit->addToVisibleUnits(*i);
+		}
+		if (unit->getFaction() == FACTION_PLAYER)
+			(*i)->setVisible(true);
+	}
+
+	// only the player's units discover the map, aliens' views just go into the threat map
+	if (unit->getFaction() == FACTION_PLAYER)
+	{
+		for (std::vector<Tile*>::const_iterator i = tiles.begin(); i != tiles.end(); ++i)
+		{
+			Position pos = (*i)->getPosition();
+			unit->addToVisibleTiles(*i);
+			(*i)->setDiscovered(true, 2);
+			(*i)->setVisible(+1);
+			// walls to the east or south of a visible tile, we see that too
+			Tile* t = _save->getTile(Position(pos.x + 1, pos.y, pos.z));
+			if (t) t->setDiscovered(true, 0);
+			t = _save->getTile(Position(pos.x, pos.y + 1, pos.z));
+			if (t) t->setDiscovered(true, 1);
+		}
+	}
+
+	_save->getThreatMap()->addWatcher(unit, tiles);
 
 	int newChecksum = 0;
 	for (std::vector<BattleUnit*>::iterator i = unit->getVisibleUnits()->begin(); i != unit->getVisibleUnits()->end(); ++i)
@@ -436,7 +634,7 @@ bool TileEngine::checkReactionFire(BattleUnit *unit, BattleAction *action, Battl
 		return false;
 	}
 
-	if (potentialVictim && RNG::generate(0, 4) == 1 && potentialVictim->getFaction() == FACTION_HOSTILE)
+	if (potentialVictim && RNG::generate(RNG::STREAM_COMBAT, 0, 4) == 1 && potentialVictim->getFaction() == FACTION_HOSTILE)
 	{
 		potentialVictim->lookAt(unit->getPosition());
 		while (potentialVictim->getStatus() == STATUS_TURNING)
@@ -525,13 +723,13 @@ void TileEngine::hit(const Position &center, int power, ItemDamageType type, Bat
 	if (part >= 0 && part <= 3)
 	{
 		// power 25% to 75%
-		int rndPower = RNG::generate(power/4, (power*3)/4); //RNG::boxMuller(power, power/6)
+		int rndPower = RNG::generate(RNG::STREAM_COMBAT, power/4, (power*3)/4); //RNG::boxMuller(RNG::STREAM_COMBAT, power, power/6)
 		tile->damage(part, rndPower);
 	}
 	else if (part == 4)
 	{
 		// power 0 - 200%
-		int rndPower = RNG::generate(0, power*2); // RNG::boxMuller(power, power/3)
+		int rndPower = RNG::generate(RNG::STREAM_COMBAT, 0, power*2); // RNG::boxMuller(RNG::STREAM_COMBAT, power, power/3)
 		BattleUnit *bu = tile->getUnit();
 		if (bu)
 		{
@@ -554,7 +752,7 @@ void TileEngine::hit(const Position &center, int power, ItemDamageType type, Bat
 		// conventional weapons can cause additional stun damage
 		if (type == DT_AP && bu)
 		{
-			bu->damage(Position(center.x%16, center.y%16, center.z%24), RNG::generate(0, rndPower/4), DT_STUN, true);
+			bu->damage(Position(center.x%16, center.y%16, center.z%24), RNG::generate(RNG::STREAM_COMBAT, 0, rndPower/4), DT_STUN, true);
 		}
 
 		if (bu && bu->getFaction() != unit->getFaction())
@@ -637,14 +835,14 @@ void TileEngine::explode(const Position &center, int power, ItemDamageType type,
 						{
 							// power 50 - 150%
 							if (dest->getUnit())
-								dest->getUnit()->damage(Position(0, 0, 0), (int)(RNG::generate(power_/2.0, power_*1.5)), type);
+								dest->getUnit()->damage(Position(0, 0, 0), (int)(RNG::generate(RNG::STREAM_COMBAT, power_/2.0, power_*1.5)), type);
 						}
 						if (type == DT_SMOKE)
 						{
 							// smoke from explosions always stay 6 to 14 turns - power of a smoke grenade is 60
 							if (dest->getSmoke() < 10)
 							{
-								dest->addSmoke(RNG::generate(power_/10, 14));
+								dest->addSmoke(RNG::generate(RNG::STREAM_COMBAT, power_/10, 14));
 							}
 						}
 						if (type == DT_IN && !dest->isVoid())
@@ -655,8 +853,8 @@ void TileEngine::explode(const Position &center, int power, ItemDamageType type,
 							}
 							if (dest->getUnit())
 							{
-								dest->getUnit()->damage(Position(0, 0, 0), RNG::generate(0, power_/3), type); // immediate IN damage
-								dest->getUnit()->setFire(RNG::generate(1, 5)); // catch fire and burn for 1-5 rounds
+								dest->getUnit()->damage(Position(0, 0, 0), RNG::generate(RNG::STREAM_COMBAT, 0, power_/3), type); // immediate IN damage
+								dest->getUnit()->setFire(RNG::generate(RNG::STREAM_COMBAT, 1, 5)); // catch fire and burn for 1-5 rounds
 							}
 						}
 
@@ -694,15 +892,10 @@ void TileEngine::explode(const Position &center, int power, ItemDamageType type,
  */
 Tile *TileEngine::checkForTerrainExplosions()
 {
-
-	for (int i = 0; i < _save->getWidth() * _save->getLength() * _save->getHeight(); ++i)
-	{
-		if (_save->getTiles()[i]->getExplosive())
-		{
-			return _save->getTiles()[i];
-		}
-	}
-	return 0;
+	const int size = _save->getWidth() * _save->getLength() * _save->getHeight();
+	ExplosiveTileTask task(_save->getTiles(), JobSystem::getChunks(0, size, TILE_GRAIN));
+	JobSystem::parallelFor(0, size, TILE_GRAIN, &task);
+	return task.getFound();
 }
 
 /**
@@ -769,10 +962,10 @@ int TileEngine::verticalBlockage(Tile *startTile, Tile *endTile, ItemDamageType
  */
 int TileEngine::horizontalBlockage(Tile *startTile, Tile *endTile, ItemDamageType type)
 {
-	static const Position oneTileNorth = Position(0, -1, 0);
-	static const Position oneTileEast = Position(1, 0, 0);
-	static const Position oneTileSouth = Position(0, 1, 0);
-	static const Position oneTileWest = Position(-1, 0, 0);
+	const Position oneTileNorth = Position(0, -1, 0);
+	const Position oneTileEast = Position(1, 0, 0);
+	const Position oneTileSouth = Position(0, 1, 0);
+	const Position oneTileWest = Position(-1, 0, 0);
 
 	// safety check
 	if (startTile == 0 || endTile == 0) return 0;
@@ -1246,6 +1439,18 @@ void TileEngine::togglePersonalLighting()
 	calculateUnitLighting();
 }
 
+/**
+ * Sets whether the tiles the aliens see are traced, so player units
+ * run by the AI can tell from the threat map where they're watched.
+ * It costs a line trace per tile on every alien view update, so it's
+ * off unless nobody is at the controls.
+ * @param hostileViews Trace alien views?
+ */
+void TileEngine::setHostileViews(bool hostileViews)
+{
+	_hostileViews = hostileViews;
+}
+
 /**
  * Distance between 2 points. Rounded up to first INT.
  * @return distance
@@ -41,7 +41,6 @@ class Tile;
 class TileEngine
 {
 private:
-	static const int MAX_VIEW_DISTANCE = 20;
 	static const int MAX_DARKNESS_TO_SEE_UNITS = 9;
 	SavedBattleGame *_save;
 	std::vector<Uint16> *_voxelData;
@@ -49,8 +48,10 @@ private:
 	int blockage(Tile *tile, const int part, ItemDamageType type);
 	int vectorToDirection(const Position &vector);
 	int voxelCheck(const Position& voxel, BattleUnit *excludeUnit, bool excludeAllUnits = false);
-	bool _personalLighting;
+	bool _personalLighting, _hostileViews;
+	bool applyFOV(BattleUnit *unit, const std::vector<BattleUnit*> &units, const std::vector<Tile*> &tiles);
 public:
+	static const int MAX_VIEW_DISTANCE = 20;
 	/// Creates a new TileEngine class.
 	TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData);
 	/// Cleans up the TileEngine.
@@ -61,6 +62,10 @@ public:
 	void calculateSunShading(Tile *tile);
 	/// Calculate the field of view from a units view point.
 	bool calculateFOV(BattleUnit *unit);
+	/// Calculate the field of view of several units at once.
+	void calculateFOV(const std::vector<BattleUnit*> &units);
+	/// Find the units and tiles a unit can see, without changing anything.
+	void findVisible(BattleUnit *unit, std::vector<BattleUnit*> *units, std::vector<Tile*> *tiles);
 	/// Calculate the field of view within range of a certain position.
 	void calculateFOV(const Position &position);
 	/// Check reaction fire.
@@ -69,6 +74,8 @@ public:
 	void calculateTerrainLighting();
 	/// Recalculate lighting of the battlescape.
 	void calculateUnitLighting();
+	/// Add a circular light pattern on some levels of the battlescape.
+	void addLight(const Position &center, int power, int layer, int zBegin, int zEnd);
 	/// Explosions.
 	void hit(const Position &center, int power, ItemDamageType type, BattleUnit *unit);
 	void explode(const Position &center, int power, ItemDamageType type, int maxRadius, BattleUnit *unit = 0);
@@ -84,6 +91,8 @@ public:
 	int calculateParabola(const Position& origin, const Position& target, bool storeTrajectory, std::vector<Position> *trajectory, BattleUnit *excludeUnit, double curvature, double accuracy);
 	bool visible(BattleUnit *currentUnit, Tile *tile);
 	void togglePersonalLighting();
+	/// Sets whether the aliens' views are traced for the threat map.
+	void setHostileViews(bool hostileViews);
 	int distance(const Position &pos1, const Position &pos2) const;
 	int horizontalBlockage(Tile *startTile, Tile *endTile, ItemDamageType type);
 	int verticalBlockage(Tile *startTile, Tile *endTile, ItemDamageType type);
@@ -20,6 +20,7 @@
 #include "UnitDieBState.h"
 #include "ExplosionBState.h"
 #include "TileEngine.h"
+#include "ThreatMap.h"
 #include "BattlescapeState.h"
 #include "Map.h"
 #include "Camera.h"
@@ -63,11 +64,11 @@ UnitDieBState::UnitDieBState(BattlescapeGame *parent, BattleUnit *unit, ItemDama
 	{
 		if ((_unit->getType() == "SOLDIER" && _unit->getGender() == GENDER_MALE) || _unit->getType() == "MALE_CIVILIAN")
 		{
-			_parent->getResourcePack()->getSoundSet("BATTLE.CAT")->getSound(RNG::generate(41,43))->play();
+			_parent->getResourcePack()->getSoundSet("BATTLE.CAT")->getSound(RNG::generate(RNG::STREAM_COSMETIC, 41,43))->play();
 		}
 		else if ((_unit->getType() == "SOLDIER" && _unit->getGender() == GENDER_FEMALE) || _unit->getType() == "FEMALE_CIVILIAN")
 		{
-			_parent->getResourcePack()->getSoundSet("BATTLE.CAT")->getSound(RNG::generate(44,46))->play();
+			_parent->getResourcePack()->getSoundSet("BATTLE.CAT")->getSound(RNG::generate(RNG::STREAM_COSMETIC, 44,46))->play();
 		}
 		else
 		{
@@ -111,6 +112,8 @@ void UnitDieBState::think()
 	if (_unit->getStatus() == STATUS_DEAD || _unit->getStatus() == STATUS_UNCONSCIOUS)
 	{
 		convertUnitToCorpse();
+		// a unit that's out no longer watches anything
+		_parent->getSave()->getThreatMap()->removeWatcher(_unit);
 		_parent->getTileEngine()->calculateUnitLighting();
 		_parent->popState();
 		if (_unit->getSpecialAbility() == SPECAB_EXPLODEONDEATH)
@@ -123,6 +126,15 @@ void UnitDieBState::think()
 	_parent->getMap()->cacheUnit(_unit);
 }
 
+/*
+ * Checks if the player can't see the unit, so the animation can be skipped.
+ * @return True if the unit is out of sight.
+ */
+bool UnitDieBState::isUnseen()
+{
+	return !_unit->getVisible() && !_parent->getSave()->getDebugMode();
+}
+
 /*
  * Unit falling cannot be cancelled.
  */
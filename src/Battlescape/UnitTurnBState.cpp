@@ -74,7 +74,7 @@ void UnitTurnBState::init()
 		}
 		if (door == 1)
 		{
-			_parent->getResourcePack()->getSoundSet("BATTLE.CAT")->getSound(RNG::generate(20,21))->play(); // ufo door
+			_parent->getResourcePack()->getSoundSet("BATTLE.CAT")->getSound(RNG::generate(RNG::STREAM_COSMETIC, 20,21))->play(); // ufo door
 		}
 		_parent->popState();
 	}
@@ -109,6 +109,15 @@ void UnitTurnBState::think()
 	}
 }
 
+/*
+ * Checks if the player can't see the unit, so the animation can be skipped.
+ * @return True if the unit is out of sight.
+ */
+bool UnitTurnBState::isUnseen()
+{
+	return !_unit->getVisible() && !_parent->getSave()->getDebugMode();
+}
+
 /*
  * Unit turning cannot be cancelled.
  */
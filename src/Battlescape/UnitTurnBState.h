@@ -43,6 +43,8 @@ public:
 	void cancel();
 	/// Runs state functionality every cycle.
 	void think();
+	/// Checks if the player can't see the unit.
+	bool isUnseen();
 	/// Get the result of the state.
 	std::string getResult() const;
 };
@@ -302,6 +302,15 @@ void UnitWalkBState::think()
 	}
 }
 
+/*
+ * Checks if the player can't see the unit, so the animation can be skipped.
+ * @return True if the unit is out of sight.
+ */
+bool UnitWalkBState::isUnseen()
+{
+	return !_unit->getVisible() && !_parent->getSave()->getDebugMode();
+}
+
 /*
  * Abort unit walking.
  */
@@ -51,6 +51,8 @@ public:
 	void cancel();
 	/// Runs state functionality every cycle. Returns false when finished.
 	void think();
+	/// Checks if the player can't see the unit.
+	bool isUnseen();
 };
 
 }
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "AssetCache.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <ctime>
+#include <cstring>
+#include <SDL.h>
+#include "CrossPlatform.h"
+
+namespace OpenXcom
+{
+namespace AssetCache
+{
+
+const char CACHE_MAGIC[4] = {'O', 'X', 'C', 'C'};
+const Uint32 CACHE_VERSION = 1;
+
+std::string _folder = "";
+
+/**
+ * File header for each cache entry.
+ */
+struct CacheHeader
+{
+	char magic[4];
+	Uint32 version;
+	Uint32 size[2];
+	Uint32 modified[2];
+	Uint32 length;
+};
+
+/**
+ * Sets up the folder where cache entries are kept,
+ * creating it if necessary. The cache stays disabled
+ * until this is called.
+ * @param folder Full path to the cache folder.
+ */
+void init(const std::string &folder)
+{
+	if (!CrossPlatform::folderExists(folder) && !CrossPlatform::createFolder(folder))
+	{
+		_folder = "";
+		return;
+	}
+	_folder = CrossPlatform::endPath(folder);
+}
+
+/**
+ * Builds the cache filename for a key. Keys are usually
+ * full paths, so they're hashed to keep them short.
+ * @param key Cache entry key.
+ * @return Full path to the cache entry.
+ */
+std::string getFilename(const std::string &key)
+{
+	Uint32 hash = 2166136261u;
+	for (std::string::const_iterator i = key.begin(); i != key.end(); ++i)
+	{
+		hash = (hash ^ (unsigned char)*i) * 16777619u;
+	}
+	std::string::size_type slash = key.find_last_of("/\\");
+	std::string name = (slash == std::string::npos) ? key : key.substr(slash + 1);
+	std::stringstream ss;
+	ss << _folder << name << "." << std::hex << std::setfill('0') << std::setw(8) << hash;
+	return ss.str();
+}
+
+/**
+ * Fills in the header with the current stats of
+ * the files a cache entry is derived from.
+ * @param header Pointer to the header.
+ * @param source First source file.
+ * @param source2 Second source file, if any.
+ * @return False if a source file is missing.
+ */
+bool getHeader(CacheHeader *header, const std::string &source, const std::string &source2)
+{
+	std::string sources[] = {source, source2};
+	memcpy(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	header->version = CACHE_VERSION;
+	header->length = 0;
+	for (int i = 0; i < 2; ++i)
+	{
+		size_t size = 0;
+		time_t modified = 0;
+		if (!sources[i].empty() && !CrossPlatform::getFileStats(sources[i], &size, &modified))
+		{
+			return false;
+		}
+		header->size[i] = (Uint32)size;
+		header->modified[i] = (Uint32)modified;
+	}
+	return true;
+}
+
+/**
+ * Loads the data cached for a key, as long as the
+ * files it was made from haven't changed since.
+ * @param key Cache entry key.
+ * @param source First source file.
+ * @param data Pointer to the buffer to fill.
+ * @param source2 Second source file, if any.
+ * @return True if there was valid cached data.
+ */
+bool load(const std::string &key, const std::string &source, std::vector<unsigned char> *data, const std::string &source2)
+{
+	CacheHeader expected, header;
+	if (_folder.empty() || !getHeader(&expected, source, source2))
+	{
+		return false;
+	}
+	std::ifstream file (getFilename(key).c_str(), std::ios::in | std::ios::binary);
+	if (!file || !file.read((char*)&header, sizeof(header)))
+	{
+		return false;
+	}
+	expected.length = header.length;
+	if (memcmp(&header, &expected, sizeof(header)) != 0)
+	{
+		return false;
+	}
+	data->resize(header.length);
+	if (header.length > 0 && !file.read((char*)&(*data)[0], header.length))
+	{
+		data->clear();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Stores the data decoded from a set of files, so it
+ * can be loaded straight back on the next launch.
+ * Failing to write the cache is not an error.
+ * @param key Cache entry key.
+ * @param source First source file.
+ * @param data Decoded data.
+ * @param source2 Second source file, if any.
+ */
+void save(const std::string &key, const std::string &source, const std::vector<unsigned char> &data, const std::string &source2)
+{
+	CacheHeader header;
+	if (_folder.empty() || !getHeader(&header, source, source2))
+	{
+		return;
+	}
+	header.length = data.size();
+	std::ofstream file (getFilename(key).c_str(), std::ios::out | std::ios::binary);
+	if (!file)
+	{
+		return;
+	}
+	file.write((const char*)&header, sizeof(header));
+	if (!data.empty())
+	{
+		file.write((const char*)&data[0], data.size());
+	}
+}
+
+}
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_ASSETCACHE_H
+#define OPENXCOM_ASSETCACHE_H
+
+#include <string>
+#include <vector>
+
+namespace OpenXcom
+{
+
+/**
+ * Keeps already decoded game data in the user folder
+ * so it doesn't have to be converted from the original
+ * formats on every launch. Each entry remembers the size
+ * and modification time of the files it came from and is
+ * ignored as soon as any of them changes.
+ */
+namespace AssetCache
+{
+	/// Sets the folder to keep the cache in.
+	void init(const std::string &folder);
+	/// Loads the cached data for a set of files.
+	bool load(const std::string &key, const std::string &source, std::vector<unsigned char> *data, const std::string &source2 = "");
+	/// Stores the data decoded from a set of files.
+	void save(const std::string &key, const std::string &source, const std::vector<unsigned char> &data, const std::string &source2 = "");
+}
+
+}
+
+#endif
@@ -18,71 +18,144 @@
  */
 
 #include "CatFile.h"
+#include <fstream>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 namespace OpenXcom
 {
 
 /**
- * Creates a CAT file stream. A CAT file starts with an index of the
+ * Creates a CAT file view. A CAT file starts with an index of the
  * offset and size of every file contained within. Each file consists
- * of a filename followed by its contents.
+ * of a filename followed by its contents. The file is memory-mapped
+ * if possible, otherwise it's read in whole.
  * @param path Full path to CAT file.
  */
-CatFile::CatFile(const char *path) : std::ifstream(path, std::ios::in | std::ios::binary), _amount(0), _offset(0), _size(0)
+CatFile::CatFile(const char *path) : _data(0), _dataSize(0), _mapping(0), _buffer(), _amount(0), _offset(0), _size(0)
 {
-	if (!this)
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		_dataSize = GetFileSize(file, 0);
+		HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+		if (mapping != 0)
+		{
+			_data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if (_data != 0)
+				_mapping = mapping;
+			else
+				CloseHandle(mapping);
+		}
+		CloseHandle(file);
+	}
+#else
+	int file = open(path, O_RDONLY);
+	if (file != -1)
+	{
+		struct stat info;
+		if (fstat(file, &info) == 0 && info.st_size > 0)
+		{
+			void *data = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (data != MAP_FAILED)
+			{
+				_data = (const char*)data;
+				_dataSize = info.st_size;
+				_mapping = data;
+			}
+		}
+		close(file);
+	}
+#endif
+
+	// Fall back to reading the whole file
+	if (_data == 0)
+	{
+		std::ifstream file (path, std::ios::in | std::ios::binary);
+		if (!file)
+			return;
+		file.seekg(0, std::ios::end);
+		_dataSize = file.tellg();
+		file.seekg(0, std::ios::beg);
+		_buffer.resize(_dataSize + 1);
+		file.read(&_buffer[0], _dataSize);
+		_data = &_buffer[0];
+	}
+
+	if (_dataSize < sizeof(_amount))
 		return;
 
 	// Get amount of files
-	read((char*)&_amount, sizeof(_amount));
+	memcpy(&_amount, _data, sizeof(_amount));
 	_amount /= 2 * sizeof(_amount);
+	if (_amount * 2 * sizeof(_amount) > _dataSize)
+		_amount = _dataSize / (2 * sizeof(_amount));
 
 	// Get object offsets
-	seekg(0, std::ios::beg);
-
 	_offset = new unsigned int[_amount];
 	_size   = new unsigned int[_amount];
 
 	for (unsigned int i = 0; i < _amount; ++i)
 	{
-		read((char*)&_offset[i], sizeof(*_offset));
-		read((char*)&_size[i],   sizeof(*_size));
+		memcpy(&_offset[i], _data + i * 2 * sizeof(_amount), sizeof(*_offset));
+		memcpy(&_size[i], _data + (i * 2 + 1) * sizeof(_amount), sizeof(*_size));
+
+		// Skip filename
+		if (_offset[i] < _dataSize)
+		{
+			_offset[i] += 1 + (unsigned char)_data[_offset[i]];
+		}
+		if (_offset[i] >= _dataSize)
+		{
+			_offset[i] = 0;
+			_size[i] = 0;
+		}
+		else if (_size[i] > _dataSize - _offset[i])
+		{
+			_size[i] = _dataSize - _offset[i];
+		}
 	}
 }
 
 /**
- * Frees associated memory.
+ * Unmaps the file and frees associated memory.
  */
 CatFile::~CatFile()
 {
 	delete[] _offset;
 	delete[] _size;
 
-	close();
+	if (_mapping != 0)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(_data);
+		CloseHandle((HANDLE)_mapping);
+#else
+		munmap(_mapping, _dataSize);
+#endif
+	}
 }
 
 /**
- * Loads an object into memory.
- * @param i Object number to load.
- * @return Pointer to the loaded object.
+ * Returns an object's contents, straight from the
+ * file in memory. Only valid as long as the CAT is.
+ * @param i Object number.
+ * @return Pointer to the object's contents, or 0 if it doesn't exist.
  */
-char *CatFile::load(unsigned int i)
+const char *CatFile::getObject(unsigned int i) const
 {
-	if (i >= _amount)
+	if (i >= _amount || _size[i] == 0)
 		return 0;
 
-	seekg(_offset[i], std::ios::beg);
-
-	// Skip filename
-	char namesize;
-	read(&namesize, 1);
-	seekg(namesize, std::ios::cur);
-
-	// Read object
-	char *object = new char[_size[i]];
-	read(object, _size[i]);
-
-	return object;
+	return _data + _offset[i];
 }
 
 }
@@ -20,27 +20,34 @@
 #ifndef OPENXCOM_CATFILE_H
 #define OPENXCOM_CATFILE_H
 
-#include <fstream>
+#include <cstddef>
+#include <vector>
 
 namespace OpenXcom
 {
 
 /**
- * Subclass of std::ifstream to handle CAT files
+ * Read-only view of a CAT file. The whole file is mapped
+ * into memory, and objects are handed out as pointers into
+ * it instead of being copied.
  */
-class CatFile : protected std::ifstream
+class CatFile
 {
 private:
+	const char *_data;
+	size_t _dataSize;
+	void *_mapping;
+	std::vector<char> _buffer;
 	unsigned int _amount, *_offset, *_size;
 public:
-	/// Creates a CAT file stream.
+	/// Creates a CAT file view.
 	CatFile(const char *path);
-	/// Cleans up the stream.
+	/// Cleans up the view.
 	~CatFile();
-	/// Inherit operator.
+	/// Checks if the file failed to open.
 	bool operator !() const
 	{
-		return std::ifstream::operator!();
+		return _data == 0;
 	}
 	/// Get amount of objects.
 	int getAmount() const
@@ -52,8 +59,8 @@ public:
 	{
 		return (i < _amount) ? _size[i] : 0;
 	}
-	/// Load an object into memory.
-	char *load(unsigned int i);
+	/// Gets an object's contents.
+	const char *getObject(unsigned int i) const;
 };
 
 }
@@ -18,6 +18,7 @@
  */
 #include "CrossPlatform.h"
 #include <iostream>
+#include <fstream>
 #include <algorithm>
 #include "../dirent.h"
 #include "Exception.h"
@@ -27,6 +28,7 @@
 #include <shlobj.h>
 #include <shlwapi.h>
 #include <direct.h>
+#include <sys/stat.h>
 #ifndef SHGFP_TYPE_CURRENT
 #define SHGFP_TYPE_CURRENT 0
 #endif
@@ -449,5 +451,55 @@ bool fileExists(const std::string &path)
 #endif
 }
 
+/**
+ * Gets the size and last modification time of a file,
+ * used to check if anything derived from it is stale.
+ * @param path Full path to file.
+ * @param size Pointer to the file size.
+ * @param modified Pointer to the modification time.
+ * @return True if the file exists.
+ */
+bool getFileStats(const std::string &path, size_t *size, time_t *modified)
+{
+#ifdef _WIN32
+	struct _stat info;
+	if (_stat(path.c_str(), &info) != 0)
+#else
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0)
+#endif
+	{
+		return false;
+	}
+	*size = (size_t)info.st_size;
+	*modified = info.st_mtime;
+	return true;
+}
+
+/**
+ * Reads the whole contents of a file into memory in a single
+ * operation, so decoders can work straight off a buffer.
+ * @param path Full path to file.
+ * @param data Pointer to the buffer to fill.
+ * @return True if the file was read successfully.
+ */
+bool readFile(const std::string &path, std::vector<unsigned char> *data)
+{
+	std::ifstream file (path.c_str(), std::ios::in | std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+	file.seekg(0, std::ios::end);
+	std::streamoff size = file.tellg();
+	file.seekg(0, std::ios::beg);
+	data->resize((size_t)size);
+	if (size > 0 && !file.read((char*)&(*data)[0], size))
+	{
+		return false;
+	}
+	return true;
+}
+
 }
 }
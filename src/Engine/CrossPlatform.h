@@ -21,6 +21,7 @@
 
 #include <string>
 #include <vector>
+#include <ctime>
 
 namespace OpenXcom
 {
@@ -53,6 +54,10 @@ namespace CrossPlatform
 	bool folderExists(const std::string &path);
 	/// Checks if the path is an existing file.
 	bool fileExists(const std::string &path);
+	/// Gets the size and modification time of a file.
+	bool getFileStats(const std::string &path, size_t *size, time_t *modified);
+	/// Reads the whole contents of a file.
+	bool readFile(const std::string &path, std::vector<unsigned char> *data);
 }
 
 }
@@ -50,10 +50,22 @@ Font::~Font()
 /**
  * Calculates the real size and position of each character in
  * the surface and stores them in SDL_Rect's for future use
- * by other classes.
+ * by other classes. The rects are kept in a table indexed
+ * by character, so they can be looked up directly.
  */
 void Font::load()
 {
+	wchar_t last = L'?';
+	for (std::wstring::const_iterator i = _index.begin(); i != _index.end(); ++i)
+	{
+		if (*i > last)
+		{
+			last = *i;
+		}
+	}
+	SDL_Rect unknown = {0, 0, 0, 0};
+	_chars.assign(last + 1, unknown);
+
 	_surface->lock();
 	for (unsigned int i = 0; i < _index.length(); ++i)
 	{
@@ -89,6 +101,16 @@ void Font::load()
 		_chars[_index[i]] = rect;
 	}
 	_surface->unlock();
+
+	// Unknown characters are drawn as question marks
+	unknown = _chars[L'?'];
+	for (std::vector<SDL_Rect>::iterator i = _chars.begin(); i != _chars.end(); ++i)
+	{
+		if (i->w == 0 && i->h == 0)
+		{
+			*i = unknown;
+		}
+	}
 }
 
 /**
@@ -130,16 +152,30 @@ void Font::loadIndex(const std::string &filename)
  */
 Surface *const Font::getChar(wchar_t c)
 {
-	if (_chars.find(c) == _chars.end())
+	const SDL_Rect &rect = getCharSize(c);
+	_surface->getCrop()->x = rect.x;
+	_surface->getCrop()->y = rect.y;
+	_surface->getCrop()->w = rect.w;
+	_surface->getCrop()->h = rect.h;
+	return _surface;
+}
+
+/**
+ * Returns the size and position of a particular character
+ * in the font's surface, without touching the surface.
+ * @param c Character to look up.
+ * @return Rectangle of the character, or of '?' if the
+ * font doesn't contain it.
+ */
+const SDL_Rect &Font::getCharSize(wchar_t c) const
+{
+	if ((size_t)c >= _chars.size())
 	{
-		c = '?';
+		c = L'?';
 	}
-	_surface->getCrop()->x = _chars[c].x;
-	_surface->getCrop()->y = _chars[c].y;
-	_surface->getCrop()->w = _chars[c].w;
-	_surface->getCrop()->h = _chars[c].h;
-	return _surface;
+	return _chars[c];
 }
+
 /**
  * Returns the maximum width for any character in the font.
  * @return Width in pixels.
@@ -19,7 +19,7 @@
 #ifndef OPENXCOM_FONT_H
 #define OPENXCOM_FONT_H
 
-#include <map>
+#include <vector>
 #include <string>
 #include <SDL.h>
 
@@ -41,7 +41,7 @@ private:
 	static std::wstring _index;
 	Surface *_surface;
 	int _width, _height;
-	std::map<wchar_t, SDL_Rect> _chars;
+	std::vector<SDL_Rect> _chars;
 	int _spacing; // For some reason the X-Com small font is smooshed together by one pixel...
 public:
 	/// Creates a font with a blank surface.
@@ -54,6 +54,8 @@ public:
 	static void loadIndex(const std::string &filename);
 	/// Gets a particular character from the font, with its real size.
 	Surface *const getChar(wchar_t c);
+	/// Gets the size and position of a particular character in the font.
+	const SDL_Rect &getCharSize(wchar_t c) const;
 	/// Gets the font's character width.
 	int getWidth() const;
 	/// Gets the font's character height.
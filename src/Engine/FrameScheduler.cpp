@@ -0,0 +1,174 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "FrameScheduler.h"
+#include "Timer.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Initializes a frame scheduler with no pending work.
+ */
+FrameScheduler::FrameScheduler() : _frameStart(0), _step(0), _dirty(true), _busy(false), _realTime(true)
+{
+}
+
+/**
+ *
+ */
+FrameScheduler::~FrameScheduler()
+{
+}
+
+/**
+ * Starts timing a new game cycle and clears
+ * any changes from the previous one.
+ */
+void FrameScheduler::start()
+{
+	_frameStart = SDL_GetTicks();
+	_dirty = false;
+	_busy = false;
+	Timer::resetFrame();
+}
+
+/**
+ * Marks the screen as changed, so it's
+ * redrawn at the end of this game cycle.
+ */
+void FrameScheduler::setDirty()
+{
+	_dirty = true;
+}
+
+/**
+ * Returns if anything changed this game cycle, either
+ * by being marked explicitly or by any timer firing.
+ * @return True if the screen needs a redraw, False otherwise.
+ */
+bool FrameScheduler::isDirty() const
+{
+	return (_dirty || _busy || Timer::hasFired());
+}
+
+/**
+ * Marks the game as having work that isn't driven by
+ * a timer, so the next game cycle runs without sleeping.
+ * Busy cycles are always redrawn.
+ */
+void FrameScheduler::setBusy()
+{
+	_busy = true;
+}
+
+/**
+ * Returns if the next game cycle has to run right away.
+ * @return True if busy, False otherwise.
+ */
+bool FrameScheduler::isBusy() const
+{
+	return _busy;
+}
+
+/**
+ * Returns how long the current game cycle
+ * has been running so far.
+ * @return Time in milliseconds.
+ */
+Uint32 FrameScheduler::getFrameTime() const
+{
+	return SDL_GetTicks() - _frameStart;
+}
+
+/**
+ * Sleeps until the earliest timer advanced this game cycle is
+ * due, or until some input arrives, whichever happens first.
+ * Busy cycles only yield for a moment, and the game sleeps
+ * longer while the window is inactive.
+ */
+void FrameScheduler::wait()
+{
+	if (_step != 0)
+	{
+		Uint32 elapsed = getFrameTime();
+		if (_realTime && elapsed < _step)
+		{
+			SDL_Delay(_step - elapsed);
+		}
+		return;
+	}
+
+	if (_busy)
+	{
+		SDL_Delay(1);
+		return;
+	}
+
+	Uint32 now = SDL_GetTicks();
+	Uint32 due = Timer::getNextDue();
+	Uint8 state = SDL_GetAppState();
+	if (state == SDL_APPACTIVE || !state)
+	{
+		// Save on CPU while in the background
+		if (due != 0xFFFFFFFF && due < now + INACTIVE_DELAY)
+		{
+			due = now + INACTIVE_DELAY;
+		}
+	}
+	if (due != 0xFFFFFFFF && due <= now)
+	{
+		SDL_Delay(1);
+		return;
+	}
+
+	// SDL can't wait for events with a timeout,
+	// so keep checking for input in short slices
+	SDL_Event ev;
+	while (due == 0xFFFFFFFF || now < due)
+	{
+		Uint32 slice = INPUT_POLL;
+		if (due != 0xFFFFFFFF && due - now < slice)
+		{
+			slice = due - now;
+		}
+		SDL_Delay(slice);
+		SDL_PumpEvents();
+		if (SDL_PeepEvents(&ev, 1, SDL_PEEKEVENT, SDL_ALLEVENTS) > 0)
+		{
+			break;
+		}
+		now = SDL_GetTicks();
+	}
+}
+
+/**
+ * Switches to running every game cycle as a fixed step of game
+ * time, used to record and replay sessions. Timers follow the
+ * same step, so the game plays out the same on any machine.
+ * @param step Milliseconds of game time per cycle.
+ * @param realTime Keep cycles at the same pace in real time, or run them as fast as possible.
+ */
+void FrameScheduler::setFixedStep(Uint32 step, bool realTime)
+{
+	_step = step;
+	_realTime = realTime;
+	Timer::setFixedStep(step);
+}
+
+}
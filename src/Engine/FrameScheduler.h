@@ -0,0 +1,67 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_FRAMESCHEDULER_H
+#define OPENXCOM_FRAMESCHEDULER_H
+
+#include <SDL.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Paces the game cycles so the game only wakes up when
+ * there's something to do. Keeps track of whether anything
+ * changed during a cycle to decide if the screen needs to
+ * be redrawn, and sleeps until the next timer is due or
+ * input arrives instead of spinning the CPU.
+ */
+class FrameScheduler
+{
+private:
+	static const Uint32 INPUT_POLL = 10;
+	static const Uint32 INACTIVE_DELAY = 100;
+
+	Uint32 _frameStart, _step;
+	bool _dirty, _busy, _realTime;
+public:
+	/// Creates a new frame scheduler.
+	FrameScheduler();
+	/// Cleans up the frame scheduler.
+	~FrameScheduler();
+	/// Starts a new game cycle.
+	void start();
+	/// Marks the screen as needing a redraw.
+	void setDirty();
+	/// Gets if the screen needs a redraw.
+	bool isDirty() const;
+	/// Asks for the next game cycle to run right away.
+	void setBusy();
+	/// Gets if the next game cycle has to run right away.
+	bool isBusy() const;
+	/// Gets the time spent on the current game cycle.
+	Uint32 getFrameTime() const;
+	/// Sleeps until the next game cycle is due.
+	void wait();
+	/// Runs every game cycle as a fixed step of game time.
+	void setFixedStep(Uint32 step, bool realTime);
+};
+
+}
+
+#endif
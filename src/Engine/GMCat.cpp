@@ -350,38 +350,48 @@ static int gmext_write_midi (const struct gmstream *stream,
 }
 
 /**
- * Loads a MIDI object into memory.
- * @param i Music number to load.
- * @return Pointer to the loaded music.
+ * Converts a music stream into a standard MIDI file.
+ * @param i Music number to convert.
+ * @param midi Pointer to the buffer to write the MIDI data to.
+ * @return True if the stream was converted.
  */
-Music *GMCatFile::loadMIDI(unsigned int i)
+bool GMCatFile::convertMIDI(unsigned int i, std::vector<unsigned char> *midi)
 {
-	Music *music = new Music;
-
-	unsigned char *raw = static_cast<unsigned char*> ((void*)load(i));
+	const unsigned char *raw = (const unsigned char*)getObject(i);
 
 	if (!raw)
-		return music;
+		return false;
 
 	// stream info
 	struct gmstream stream;
 	if (gmext_read_stream(&stream, getObjectSize(i), raw) == -1) {
-		delete[] raw;
-		return music;
+		return false;
 	}
 
-	std::vector<unsigned char> midi;
-	midi.reserve(65536);
+	midi->reserve(65536);
 
 	// fields in stream still point into raw
-	if (gmext_write_midi(&stream, midi) == -1) {
-		delete[] raw;
-		return music;
+	if (gmext_write_midi(&stream, *midi) == -1) {
+		return false;
 	}
 
-	delete[] raw;
+	return true;
+}
 
-	music->load(&midi[0], midi.size());
+/**
+ * Loads a MIDI object into memory.
+ * @param i Music number to load.
+ * @return Pointer to the loaded music.
+ */
+Music *GMCatFile::loadMIDI(unsigned int i)
+{
+	Music *music = new Music;
+
+	std::vector<unsigned char> midi;
+	if (convertMIDI(i, &midi))
+	{
+		music->load(&midi[0], midi.size());
+	}
 
 	return music;
 }
@@ -34,6 +34,8 @@
 #include "InteractiveSurface.h"
 #include "Options.h"
 #include "CrossPlatform.h"
+#include "FrameScheduler.h"
+#include "InputLog.h"
 
 namespace OpenXcom
 {
@@ -95,6 +97,9 @@ Game::Game(const std::string &title, int width, int height, int bpp) : _screen(0
 	// Create fps counter
 	_fpsCounter = new FpsCounter(15, 5, 0, 0);
 
+	// Create frame scheduler
+	_scheduler = new FrameScheduler();
+
 	// Create blank language
 	_lang = new Language();
 }
@@ -118,6 +123,7 @@ Game::~Game()
 	delete _save;
 	delete _screen;
 	delete _fpsCounter;
+	delete _scheduler;
 
 	Mix_CloseAudio();
 
@@ -128,11 +134,21 @@ Game::~Game()
  * The state machine takes care of passing all the events from SDL to the
  * active state, running any code within and blitting all the states and
  * cursor to the screen. This is run indefinitely until the game quits.
+ * The screen is only redrawn when something changed, and the game sleeps
+ * between cycles until a timer is due or some input arrives.
  */
 void Game::run()
 {
+	// recorded sessions only play back the same if every frame is the same length
+	if (InputLog::isRecording() || InputLog::isReplaying())
+	{
+		_scheduler->setFixedStep(InputLog::FRAME_STEP, !InputLog::isReplaying());
+	}
+
 	while (!_quit)
 	{
+		_scheduler->start();
+
 		// Clean up states
 		while (!_deleted.empty())
 		{
@@ -145,6 +161,7 @@ void Game::run()
 		{
 			_states.back()->init();
 			_init = true;
+			_scheduler->setDirty();
 
 			// Unpress buttons
 			_states.back()->resetAll();
@@ -153,6 +170,7 @@ void Game::run()
 			SDL_Event ev;
 			int x, y;
 			SDL_GetMouseState(&x, &y);
+			InputLog::logMouse(&x, &y);
 			ev.type = SDL_MOUSEMOTION;
 			ev.motion.x = x;
 			ev.motion.y = y;
@@ -160,8 +178,13 @@ void Game::run()
 			_states.back()->handle(&action);
 		}
 
-		// Process events
-		while (SDL_PollEvent(&_event))
+		// Process events, or the recorded ones when replaying
+		if (InputLog::isReplaying())
+		{
+			SDL_Event ev;
+			while (SDL_PollEvent(&ev));
+		}
+		while (InputLog::isReplaying() ? InputLog::pollEvent(&_event) : SDL_PollEvent(&_event))
 		{
 			// Skip mouse events if they're disabled
 			if (!_mouseActive &&
@@ -172,12 +195,14 @@ void Game::run()
 				continue;
 			}
 
+			_scheduler->setDirty();
 			if (_event.type == SDL_QUIT)
 			{
 				_quit = true;
 			}
 			else
 			{
+				InputLog::logEvent(_event);
 				Action action = Action(&_event, _screen->getXScale(), _screen->getYScale());
 				_screen->handle(&action);
 				_cursor->handle(&action);
@@ -190,8 +215,14 @@ void Game::run()
 		_fpsCounter->think();
 		_states.back()->think();
 
+		// A new state needs to be initialized right away
+		if (!_init)
+		{
+			_scheduler->setBusy();
+		}
+
 		// Process rendering
-		if (_init)
+		if (_init && _scheduler->isDirty())
 		{
 			_screen->clear();
 			std::list<State*>::iterator i = _states.end();
@@ -207,15 +238,18 @@ void Game::run()
 			}
 			_fpsCounter->blit(_screen->getSurface());
 			_cursor->blit(_screen->getSurface());
+			_screen->flip();
+			_fpsCounter->addFrame(_scheduler->getFrameTime());
 		}
-		_screen->flip();
 
 		// Save on CPU
-		Uint8 state = SDL_GetAppState();
-		if (state == SDL_APPACTIVE || !state)
-			SDL_Delay(100);
-		else
-			SDL_Delay(1);
+		_scheduler->wait();
+
+		InputLog::nextFrame();
+		if (InputLog::isFinished())
+		{
+			_quit = true;
+		}
 	}
 }
 
@@ -271,6 +305,15 @@ FpsCounter *const Game::getFpsCounter() const
 	return _fpsCounter;
 }
 
+/**
+ * Returns the frame scheduler used by the game.
+ * @return Pointer to the frame scheduler.
+ */
+FrameScheduler *const Game::getFrameScheduler() const
+{
+	return _scheduler;
+}
+
 /**
  * Replaces a certain amount of colors in the palettes of the game's
  * screen and resources.
@@ -34,6 +34,7 @@ class ResourcePack;
 class SavedGame;
 class Ruleset;
 class FpsCounter;
+class FrameScheduler;
 
 /**
  * The core of the game engine, manages the game's entire contents and structure.
@@ -54,6 +55,7 @@ private:
 	Ruleset *_rules;
 	bool _quit, _init;
 	FpsCounter *_fpsCounter;
+	FrameScheduler *_scheduler;
 	bool _mouseActive;
 public:
 	/// Creates a new game and initializes SDL.
@@ -72,6 +74,8 @@ public:
 	Cursor *const getCursor() const;
 	/// Gets the FpsCounter.
 	FpsCounter *const getFpsCounter() const;
+	/// Gets the frame scheduler.
+	FrameScheduler *const getFrameScheduler() const;
 	/// Sets the game's 8bpp palette.
 	void setPalette(SDL_Color *colors, int firstcolor = 0, int ncolors = 256);
 	/// Resets the state stack to a new state.
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "IdTable.h"
+#include <map>
+#include <vector>
+
+namespace OpenXcom
+{
+namespace IdTable
+{
+
+std::map<std::string, int> _handles;
+std::vector<std::string> _ids;
+
+/**
+ * Returns the handle assigned to an ID. New IDs
+ * are assigned the next available handle.
+ * @param id String ID.
+ * @return Integer handle.
+ */
+int intern(const std::string &id)
+{
+	std::map<std::string, int>::iterator i = _handles.find(id);
+	if (i != _handles.end())
+	{
+		return i->second;
+	}
+	int handle = (int)_ids.size();
+	_handles[id] = handle;
+	_ids.push_back(id);
+	return handle;
+}
+
+/**
+ * Returns the handle assigned to an ID,
+ * without adding it to the table.
+ * @param id String ID.
+ * @return Integer handle, or -1 if the ID isn't interned.
+ */
+int find(const std::string &id)
+{
+	std::map<std::string, int>::const_iterator i = _handles.find(id);
+	if (i != _handles.end())
+	{
+		return i->second;
+	}
+	return -1;
+}
+
+/**
+ * Returns the ID that a handle was assigned to.
+ * @param handle Integer handle.
+ * @return String ID.
+ */
+const std::string &getString(int handle)
+{
+	return _ids[handle];
+}
+
+/**
+ * Returns the amount of IDs in the table,
+ * so every handle is lower than this.
+ * @return Amount of IDs.
+ */
+int size()
+{
+	return (int)_ids.size();
+}
+
+}
+}
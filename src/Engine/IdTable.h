@@ -0,0 +1,48 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_IDTABLE_H
+#define OPENXCOM_IDTABLE_H
+
+#include <string>
+
+namespace OpenXcom
+{
+
+/**
+ * Global table of interned string IDs.
+ * Maps every rule ID to a dense integer handle, so
+ * anything keyed by ID can use arrays instead of maps.
+ * Handles never change once assigned, and are only
+ * valid for the running game, they're never saved.
+ */
+namespace IdTable
+{
+	/// Gets the handle for an ID, adding it if necessary.
+	int intern(const std::string &id);
+	/// Gets the handle for an existing ID.
+	int find(const std::string &id);
+	/// Gets the ID for a handle.
+	const std::string &getString(int handle);
+	/// Gets the amount of interned IDs.
+	int size();
+}
+
+}
+
+#endif
@@ -0,0 +1,358 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "InputLog.h"
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include "Exception.h"
+#include "Options.h"
+
+namespace OpenXcom
+{
+namespace InputLog
+{
+
+/**
+ * A single recorded input, tagged with the frame it happened on.
+ */
+struct LogEntry
+{
+	int frame;
+	char kind;
+	int seed, x, y;
+	SDL_Event ev;
+};
+
+enum LogMode { LOG_NONE, LOG_RECORD, LOG_REPLAY };
+
+LogMode _mode = LOG_NONE;
+int _frame = 0, _endFrame = 0;
+std::string _digest;
+std::ofstream _out;
+std::vector<LogEntry> _entries;
+size_t _next = 0;
+
+/**
+ * Starts recording a session. The current options go in
+ * the header, since they affect how the game plays out.
+ * @param filename Full path to the log file.
+ */
+void record(const std::string &filename)
+{
+	_out.open(filename.c_str());
+	if (!_out)
+	{
+		throw Exception("Failed to create " + filename);
+	}
+	_mode = LOG_RECORD;
+	_frame = 0;
+	_out << "replay " << Options::getVersion() << std::endl;
+	std::map<std::string, std::string> options = Options::getOptions();
+	for (std::map<std::string, std::string>::iterator i = options.begin(); i != options.end(); ++i)
+	{
+		_out << "option " << i->first << " " << i->second << std::endl;
+	}
+}
+
+/**
+ * Loads a recorded session and restores the options it
+ * was recorded with. A log without a proper end record
+ * (the frame count and final digest) can't be checked,
+ * so it's refused.
+ * @param filename Full path to the log file.
+ */
+void replay(const std::string &filename)
+{
+	std::ifstream in(filename.c_str());
+	if (!in)
+	{
+		throw Exception("Failed to load " + filename);
+	}
+	_frame = 0;
+	_endFrame = 0;
+	_digest = "";
+	_entries.clear();
+	_next = 0;
+	bool ended = false;
+
+	std::string line;
+	while (std::getline(in, line))
+	{
+		std::istringstream ss(line);
+		std::string tag;
+		ss >> tag;
+		if (tag == "replay")
+		{
+			std::string version;
+			ss >> version;
+			if (version != Options::getVersion())
+			{
+				throw Exception("Version mismatch");
+			}
+		}
+		else if (tag == "option")
+		{
+			std::string id, value;
+			ss >> id;
+			std::getline(ss, value);
+			if (!value.empty() && value[0] == ' ')
+			{
+				value.erase(0, 1);
+			}
+			Options::setString(id, value);
+		}
+		else if (tag == "end")
+		{
+			ended = (ss >> _endFrame >> _digest) && _endFrame > 0;
+		}
+		else if (tag.size() == 1)
+		{
+			LogEntry e;
+			e.kind = tag[0];
+			e.seed = e.x = e.y = 0;
+			ss >> e.frame;
+			int type = 0, a = 0, b = 0, c = 0, d = 0, f = 0;
+			switch (e.kind)
+			{
+			case 's':
+				ss >> e.seed;
+				break;
+			case 'm':
+				ss >> e.x >> e.y;
+				break;
+			case 'e':
+				ss >> type >> a >> b >> c >> d >> f;
+				e.ev.type = type;
+				if (type == SDL_KEYDOWN || type == SDL_KEYUP)
+				{
+					e.ev.key.state = (type == SDL_KEYDOWN) ? SDL_PRESSED : SDL_RELEASED;
+					e.ev.key.keysym.scancode = 0;
+					e.ev.key.keysym.sym = (SDLKey)a;
+					e.ev.key.keysym.mod = (SDLMod)b;
+					e.ev.key.keysym.unicode = c;
+				}
+				else if (type == SDL_MOUSEMOTION)
+				{
+					e.ev.motion.state = a;
+					e.ev.motion.x = b;
+					e.ev.motion.y = c;
+					e.ev.motion.xrel = d;
+					e.ev.motion.yrel = f;
+				}
+				else
+				{
+					e.ev.button.button = a;
+					e.ev.button.state = b;
+					e.ev.button.x = c;
+					e.ev.button.y = d;
+				}
+				break;
+			default:
+				continue;
+			}
+			_entries.push_back(e);
+		}
+	}
+	if (!ended)
+	{
+		throw Exception(filename + " has no valid end record");
+	}
+	_mode = LOG_REPLAY;
+}
+
+/**
+ * Returns if a session is being recorded.
+ * @return True if recording.
+ */
+bool isRecording()
+{
+	return _mode == LOG_RECORD;
+}
+
+/**
+ * Returns if a session is being played back.
+ * @return True if replaying.
+ */
+bool isReplaying()
+{
+	return _mode == LOG_REPLAY;
+}
+
+/**
+ * Returns if the played back session has run
+ * as many frames as the recording did.
+ * @return True if the replay is over.
+ */
+bool isFinished()
+{
+	return _mode == LOG_REPLAY && _frame >= _endFrame;
+}
+
+/**
+ * Returns the number of frames run since the
+ * recording or replay started.
+ * @return Frame number.
+ */
+int getFrame()
+{
+	return _frame;
+}
+
+/**
+ * Moves the log on to the next frame.
+ */
+void nextFrame()
+{
+	// anything left over means the replay went off track,
+	// don't let it hold up the following frames
+	while (_mode == LOG_REPLAY && _next < _entries.size() && _entries[_next].frame <= _frame)
+	{
+		_next++;
+	}
+	_frame++;
+}
+
+/**
+ * Checks if the next played back entry is of a given kind
+ * and belongs to the current frame.
+ * @param kind Entry kind.
+ * @return Pointer to the entry, or 0 if there isn't one.
+ */
+const LogEntry *peek(char kind)
+{
+	if (_next < _entries.size() && _entries[_next].frame <= _frame && _entries[_next].kind == kind)
+	{
+		return &_entries[_next];
+	}
+	return 0;
+}
+
+/**
+ * Records a new random seed, or replaces it
+ * with the one used in the recording.
+ * @param seed Seed about to be used.
+ * @return Seed to use.
+ */
+int logSeed(int seed)
+{
+	if (_mode == LOG_RECORD)
+	{
+		_out << "s " << _frame << " " << seed << std::endl;
+	}
+	else if (const LogEntry *e = peek('s'))
+	{
+		seed = e->seed;
+		_next++;
+	}
+	return seed;
+}
+
+/**
+ * Records the mouse position, or replaces it
+ * with the one in the recording.
+ * @param x Pointer to the X position.
+ * @param y Pointer to the Y position.
+ */
+void logMouse(int *x, int *y)
+{
+	if (_mode == LOG_RECORD)
+	{
+		_out << "m " << _frame << " " << *x << " " << *y << std::endl;
+	}
+	else if (const LogEntry *e = peek('m'))
+	{
+		*x = e->x;
+		*y = e->y;
+		_next++;
+	}
+}
+
+/**
+ * Records an input event that's about to be handled.
+ * Only keyboard and mouse events affect the game.
+ * @param ev SDL event.
+ */
+void logEvent(const SDL_Event &ev)
+{
+	if (_mode != LOG_RECORD)
+		return;
+	switch (ev.type)
+	{
+	case SDL_KEYDOWN:
+	case SDL_KEYUP:
+		_out << "e " << _frame << " " << (int)ev.type << " " << (int)ev.key.keysym.sym << " " << (int)ev.key.keysym.mod << " " << (int)ev.key.keysym.unicode << std::endl;
+		break;
+	case SDL_MOUSEMOTION:
+		_out << "e " << _frame << " " << (int)ev.type << " " << (int)ev.motion.state << " " << ev.motion.x << " " << ev.motion.y << " " << ev.motion.xrel << " " << ev.motion.yrel << std::endl;
+		break;
+	case SDL_MOUSEBUTTONDOWN:
+	case SDL_MOUSEBUTTONUP:
+		_out << "e " << _frame << " " << (int)ev.type << " " << (int)ev.button.button << " " << (int)ev.button.state << " " << ev.button.x << " " << ev.button.y << std::endl;
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * Gets the next input event recorded on the current frame.
+ * @param ev Pointer to the event to fill in.
+ * @return True if there was an event, False once the frame has none left.
+ */
+bool pollEvent(SDL_Event *ev)
+{
+	if (const LogEntry *e = peek('e'))
+	{
+		*ev = e->ev;
+		_next++;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Ends the session. Recordings store the digest of the final
+ * game state, replays compare theirs against it. Without a
+ * game there's no state to digest, so a recording gets no
+ * end record (and can't be replayed) and a replay never matches.
+ * @param digest Digest of the final game state, empty if there's no game.
+ * @return True if the session was recorded or replayed into the recorded state.
+ */
+bool finish(const std::string &digest)
+{
+	bool match = !digest.empty();
+	if (_mode == LOG_RECORD)
+	{
+		if (match)
+		{
+			_out << "end " << _frame << " " << digest << std::endl;
+		}
+		_out.close();
+	}
+	else if (_mode == LOG_REPLAY)
+	{
+		match = match && (digest == _digest);
+	}
+	_mode = LOG_NONE;
+	return match;
+}
+
+}
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_INPUTLOG_H
+#define OPENXCOM_INPUTLOG_H
+
+#include <string>
+#include <SDL.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Records everything that feeds into a game session (options,
+ * random seeds and the input events reaching the states) so
+ * it can be played back later without anyone at the keyboard.
+ * Both recording and replaying run the game on a fixed time
+ * step per frame, so the same input lands on the same frame
+ * and the session plays out exactly the same way.
+ */
+namespace InputLog
+{
+	/// Game time that passes every frame while recording or replaying, in milliseconds.
+	const Uint32 FRAME_STEP = 10;
+
+	/// Starts recording a session to a file.
+	void record(const std::string &filename);
+	/// Loads a recorded session to play back.
+	void replay(const std::string &filename);
+	/// Gets if a session is being recorded.
+	bool isRecording();
+	/// Gets if a session is being played back.
+	bool isReplaying();
+	/// Gets if the played back session has reached its end.
+	bool isFinished();
+	/// Gets the number of frames run so far.
+	int getFrame();
+	/// Moves on to the next frame.
+	void nextFrame();
+	/// Records or plays back a random seed.
+	int logSeed(int seed);
+	/// Records or plays back the mouse position.
+	void logMouse(int *x, int *y);
+	/// Records an input event.
+	void logEvent(const SDL_Event &ev);
+	/// Gets the next played back input event for this frame.
+	bool pollEvent(SDL_Event *ev);
+	/// Ends the session with the final state digest.
+	bool finish(const std::string &digest);
+}
+
+}
+
+#endif
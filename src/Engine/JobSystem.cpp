@@ -0,0 +1,276 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "JobSystem.h"
+#include <vector>
+#include <algorithm>
+#include <SDL.h>
+
+namespace OpenXcom
+{
+
+namespace JobSystem
+{
+
+/// Chunks dealt out to one thread, taken from the front by the owner and from the back by thieves.
+struct Queue
+{
+	SDL_mutex *mutex;
+	int front, back;
+};
+
+std::vector<SDL_Thread*> _workers;
+std::vector<Queue> _queues;
+SDL_mutex *_lock = 0;
+SDL_cond *_wake = 0, *_done = 0;
+unsigned int _generation = 0;
+int _pending = 0;
+bool _quit = false, _running = false;
+ParallelTask *_task = 0;
+int _begin = 0, _end = 0, _grain = 1;
+
+/**
+ * Takes the next chunk for a thread: from the front of its own
+ * queue, or failing that, from the back of someone else's.
+ * @param self Index of the thread.
+ * @param chunk Pointer to store the chunk in.
+ * @return False if there's nothing left to do.
+ */
+bool takeChunk(int self, int *chunk)
+{
+	int threads = _queues.size();
+	for (int i = 0; i < threads; ++i)
+	{
+		Queue &queue = _queues[(self + i) % threads];
+		SDL_LockMutex(queue.mutex);
+		if (queue.front < queue.back)
+		{
+			*chunk = (i == 0) ? queue.front++ : --queue.back;
+			SDL_UnlockMutex(queue.mutex);
+			return true;
+		}
+		SDL_UnlockMutex(queue.mutex);
+	}
+	return false;
+}
+
+/**
+ * Runs chunks of the current task until there are none left.
+ * @param self Index of the thread.
+ */
+void runChunks(int self)
+{
+	int chunk;
+	while (takeChunk(self, &chunk))
+	{
+		int begin = _begin + chunk * _grain;
+		_task->run(chunk, begin, std::min(_end, begin + _grain));
+	}
+}
+
+/**
+ * Worker loop: sleeps until there's a new task, helps with it,
+ * then reports back.
+ * @param data Index of the thread.
+ * @return Always 0.
+ */
+int work(void *data)
+{
+	int self = (int)(size_t)data;
+	unsigned int seen = 0;
+	while (true)
+	{
+		SDL_LockMutex(_lock);
+		while (_generation == seen && !_quit)
+		{
+			SDL_CondWait(_wake, _lock);
+		}
+		if (_quit)
+		{
+			SDL_UnlockMutex(_lock);
+			break;
+		}
+		seen = _generation;
+		SDL_UnlockMutex(_lock);
+
+		runChunks(self);
+
+		SDL_LockMutex(_lock);
+		if (--_pending == 0)
+		{
+			SDL_CondSignal(_done);
+		}
+		SDL_UnlockMutex(_lock);
+	}
+	return 0;
+}
+
+/**
+ * Starts the worker threads. The calling thread always takes part
+ * in the work too, so one thread means no workers at all.
+ * @param threads Total number of threads to spread work over.
+ */
+void init(int threads)
+{
+	quit();
+	Queue queue = {SDL_CreateMutex(), 0, 0};
+	_queues.push_back(queue);
+	if (threads <= 1)
+		return;
+
+	_lock = SDL_CreateMutex();
+	_wake = SDL_CreateCond();
+	_done = SDL_CreateCond();
+	for (int i = 1; i < threads; ++i)
+	{
+		Queue queue = {SDL_CreateMutex(), 0, 0};
+		_queues.push_back(queue);
+		SDL_Thread *thread = SDL_CreateThread(work, (void*)(size_t)i);
+		if (thread == 0)
+		{
+			SDL_DestroyMutex(_queues.back().mutex);
+			_queues.pop_back();
+			break;
+		}
+		_workers.push_back(thread);
+	}
+}
+
+/**
+ * Stops the worker threads and frees everything.
+ */
+void quit()
+{
+	if (_lock != 0)
+	{
+		SDL_LockMutex(_lock);
+		_quit = true;
+		SDL_CondBroadcast(_wake);
+		SDL_UnlockMutex(_lock);
+	}
+	for (std::vector<SDL_Thread*>::iterator i = _workers.begin(); i != _workers.end(); ++i)
+	{
+		SDL_WaitThread(*i, 0);
+	}
+	_workers.clear();
+	for (std::vector<Queue>::iterator i = _queues.begin(); i != _queues.end(); ++i)
+	{
+		SDL_DestroyMutex(i->mutex);
+	}
+	_queues.clear();
+	if (_lock != 0)
+	{
+		SDL_DestroyCond(_done);
+		SDL_DestroyCond(_wake);
+		SDL_DestroyMutex(_lock);
+		_lock = 0;
+	}
+	_quit = false;
+}
+
+/**
+ * Gets the number of threads the work is shared between,
+ * including the calling thread.
+ * @return Number of threads.
+ */
+int getThreads()
+{
+	return _workers.size() + 1;
+}
+
+/**
+ * Gets the number of chunks a range is cut into. This only
+ * depends on the range and grain, never on the threads, so
+ * tasks can size their per-chunk results with it.
+ * @param begin First index of the range.
+ * @param end Index past the end of the range.
+ * @param grain Number of indexes per chunk.
+ * @return Number of chunks.
+ */
+int getChunks(int begin, int end, int grain)
+{
+	if (end <= begin)
+		return 0;
+	return (end - begin + grain - 1) / grain;
+}
+
+/**
+ * Runs a task over a range of indexes, cut into chunks of a fixed
+ * size, and returns once every chunk is done. Runs everything on
+ * the calling thread when there are no workers, when there's only
+ * a single chunk or when another task is already running
+ * (from inside a task, or from another thread).
+ * @param begin First index of the range.
+ * @param end Index past the end of the range.
+ * @param grain Number of indexes per chunk.
+ * @param task Pointer to the task to run.
+ */
+void parallelFor(int begin, int end, int grain, ParallelTask *task)
+{
+	int chunks = getChunks(begin, end, grain);
+	bool serial = _workers.empty() || chunks <= 1;
+	if (!serial)
+	{
+		SDL_LockMutex(_lock);
+		serial = _running;
+		_running = true;
+		SDL_UnlockMutex(_lock);
+	}
+	if (serial)
+	{
+		for (int chunk = 0; chunk < chunks; ++chunk)
+		{
+			int first = begin + chunk * grain;
+			task->run(chunk, first, std::min(end, first + grain));
+		}
+		return;
+	}
+
+	// deal the chunks out evenly, the workers are all asleep at this point
+	int threads = _queues.size();
+	for (int i = 0; i < threads; ++i)
+	{
+		_queues[i].front = chunks * i / threads;
+		_queues[i].back = chunks * (i + 1) / threads;
+	}
+	_task = task;
+	_begin = begin;
+	_end = end;
+	_grain = grain;
+
+	SDL_LockMutex(_lock);
+	_pending = _workers.size();
+	_generation++;
+	SDL_CondBroadcast(_wake);
+	SDL_UnlockMutex(_lock);
+
+	runChunks(0);
+
+	SDL_LockMutex(_lock);
+	while (_pending > 0)
+	{
+		SDL_CondWait(_done, _lock);
+	}
+	_task = 0;
+	_running = false;
+	SDL_UnlockMutex(_lock);
+}
+
+}
+
+}
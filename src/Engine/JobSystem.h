@@ -0,0 +1,64 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_JOBSYSTEM_H
+#define OPENXCOM_JOBSYSTEM_H
+
+namespace OpenXcom
+{
+
+/**
+ * A piece of work over a range of indexes that can be
+ * split up into chunks and run on several threads.
+ * Chunks must only write to their own part of the data,
+ * anything else is gathered per chunk and combined in
+ * chunk order afterwards, so the outcome doesn't depend
+ * on which thread ran what.
+ */
+class ParallelTask
+{
+public:
+	/// Cleans up the task.
+	virtual ~ParallelTask() {}
+	/// Runs one chunk of the range.
+	virtual void run(int chunk, int begin, int end) = 0;
+};
+
+/**
+ * Small pool of worker threads for map-wide passes. A range is cut
+ * into fixed-size chunks, which are dealt out evenly between the
+ * threads; a thread that runs out of chunks steals from the others.
+ * With a single thread everything simply runs on the caller.
+ */
+namespace JobSystem
+{
+	/// Starts the worker threads.
+	void init(int threads);
+	/// Stops the worker threads.
+	void quit();
+	/// Gets the number of threads sharing the work.
+	int getThreads();
+	/// Gets the number of chunks a range is cut into.
+	int getChunks(int begin, int end, int grain);
+	/// Runs a task over a range of indexes.
+	void parallelFor(int begin, int end, int grain, ParallelTask *task);
+}
+
+}
+
+#endif
@@ -66,9 +66,14 @@ void createDefault()
 	setBool("battleAltGrenade", false);
 	setBool("battlePreviewPath", false);
 	setBool("battleRangeBasedAccuracy", false);
+	setInt("battleAIBudget", 10); // milliseconds of AI thinking per cycle
 	setBool("fpsCounter", false);
 	setBool("craftLaunchAlways", false);
 	setBool("globeSeasons", false);
+	setInt("loaderThreads", 4);
+	setInt("jobThreads", 4);
+	setInt("maxCachedImages", 8);
+	setBool("assetCache", true);
 }
 
 /**
@@ -266,6 +271,26 @@ std::string getUserFolder()
 	return _userFolder;
 }
 
+/**
+ * Changes the game's current User folder where
+ * saves are stored in.
+ * @param folder Full path to User folder.
+ */
+void setUserFolder(const std::string &folder)
+{
+	_userFolder = folder;
+}
+
+/**
+ * Returns all the option settings, eg. to
+ * reproduce the current setup elsewhere.
+ * @return Map of option IDs and values.
+ */
+std::map<std::string, std::string> getOptions()
+{
+	return _options;
+}
+
 /**
  * Returns an option in string format.
  * @param id Option ID.
@@ -21,6 +21,7 @@
 
 #include <string>
 #include <vector>
+#include <map>
 
 namespace OpenXcom
 {
@@ -52,6 +53,10 @@ namespace Options
 	std::vector<std::string> *getDataList();
 	/// Gets the game's user folder.
 	std::string getUserFolder();
+	/// Sets the game's user folder.
+	void setUserFolder(const std::string &folder);
+	/// Gets all the options.
+	std::map<std::string, std::string> getOptions();
 	/// Gets a string option.
 	std::string getString(const std::string& id);
 	/// Gets an integer option.
@@ -17,9 +17,9 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RNG.h"
+#include "InputLog.h"
 #define _USE_MATH_DEFINES
 #include <cmath>
-#include <cstdlib>
 #include <ctime>
 
 namespace OpenXcom
@@ -28,10 +28,47 @@ namespace RNG
 {
 
 int _seed = 0;
+unsigned int _state[STREAM_TOTAL][4];
+
+/**
+ * Scrambles a number into a well mixed one (SplitMix32),
+ * used to spread the seed over the stream states.
+ * @param x Pointer to the counter, which is advanced.
+ * @return Mixed number.
+ */
+unsigned int splitMix(unsigned int *x)
+{
+	unsigned int z = (*x += 0x9E3779B9u);
+	z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+	z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+	return z ^ (z >> 16);
+}
+
+/**
+ * Advances a stream and returns its next 32 random bits (xoshiro128**).
+ * @param stream Stream to advance.
+ * @return Random number.
+ */
+unsigned int next(RNGStream stream)
+{
+	unsigned int *s = _state[stream];
+	unsigned int r = s[1] * 5;
+	r = ((r << 7) | (r >> 25)) * 9;
+	unsigned int t = s[1] << 9;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 11) | (s[3] >> 21);
+	return r;
+}
 
 /**
  * Seeds the random generator with a new number.
  * Defaults to the current time if none is set.
+ * Every stream gets its own state derived from the seed.
+ * Recorded sessions keep track of every seed used.
  * @param seed New seed.
  */
 void init(int seed)
@@ -44,11 +81,19 @@ void init(int seed)
 	{
 		_seed = seed;
 	}
-	srand(_seed);
+	_seed = InputLog::logSeed(_seed);
+	unsigned int x = (unsigned int)_seed;
+	for (int i = 0; i < STREAM_TOTAL; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			_state[i][j] = splitMix(&x);
+		}
+	}
 }
 
 /**
- * Returns the last seed used by the generator.
+ * Returns the seed the generator was initialized with.
  * @return Generator seed.
  */
 int getSeed()
@@ -56,64 +101,109 @@ int getSeed()
 	return _seed;
 }
 
+/**
+ * Loads the seed and the state of every stream from a YAML file.
+ * @param node YAML node.
+ */
+void load(const YAML::Node& node)
+{
+	node["seed"] >> _seed;
+	const YAML::Node &streams = node["streams"];
+	for (unsigned int i = 0; i < streams.size() && i < STREAM_TOTAL; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			streams[i][j] >> _state[i][j];
+		}
+	}
+}
+
+/**
+ * Saves the seed and the state of every stream to a YAML file.
+ * @param out YAML emitter.
+ */
+void save(YAML::Emitter& out)
+{
+	out << YAML::BeginMap;
+	out << YAML::Key << "seed" << YAML::Value << _seed;
+	out << YAML::Key << "streams" << YAML::Value;
+	out << YAML::BeginSeq;
+	for (int i = 0; i < STREAM_TOTAL; ++i)
+	{
+		out << YAML::Flow << YAML::BeginSeq;
+		for (int j = 0; j < 4; ++j)
+		{
+			out << _state[i][j];
+		}
+		out << YAML::EndSeq;
+	}
+	out << YAML::EndSeq;
+	out << YAML::EndMap;
+}
+
 /**
  * Generates a random integer number within a certain range.
+ * Numbers that would favor the low end of the range
+ * are rejected, so every result is equally likely.
+ * @param stream Stream to draw from.
  * @param min Minimum number.
  * @param max Maximum number.
  * @return Generated number.
  */
-int generate(int min, int max)
+int generate(RNGStream stream, int min, int max)
 {
-	_seed = rand();
-	return (_seed % (max - min + 1) + min);
+	if (max <= min)
+	{
+		return min;
+	}
+	unsigned int range = (unsigned int)(max - min) + 1;
+	if (range == 0)
+	{
+		return (int)next(stream);
+	}
+	unsigned int threshold = (0u - range) % range;
+	unsigned int r;
+	do
+	{
+		r = next(stream);
+	}
+	while (r < threshold);
+	return (int)(min + r % range);
 }
 
 /**
  * Generates a random decimal number within a certain range.
+ * @param stream Stream to draw from.
  * @param min Minimum number.
  * @param max Maximum number.
  * @return Generated number.
  */
-double generate(double min, double max)
+double generate(RNGStream stream, double min, double max)
 {
-	_seed = rand();
-	return (_seed * (max - min) / RAND_MAX + min);
+	return (next(stream) / 4294967295.0 * (max - min) + min);
 }
 
 /**
- * Normal random variate generator
+ * Normal random variate generator (polar Box-Muller).
+ * Only one of the two generated values is used, so
+ * no state is carried between calls.
+ * @param stream Stream to draw from.
  * @param m mean
  * @param s standard deviation
  * @return normally distributed value.
  */
-double boxMuller(double m, double s)
+double boxMuller(RNGStream stream, double m, double s)
 {
-	double y1;
-	static double y2;
-	static int use_last = 0;
-
-	if (use_last)				/* use value from previous call */
-	{
-		y1 = y2;
-		use_last = 0;
-	}
-	else
-	{
-		double x1, x2, w;
-		do {
-			x1 = 2.0 * generate(0.0, 1.0) - 1.0;
-			x2 = 2.0 * generate(0.0, 1.0) - 1.0;
-			w = x1 * x1 + x2 * x2;
-		} while ( w >= 1.0 );
+	double x1, x2, w;
+	do {
+		x1 = 2.0 * generate(stream, 0.0, 1.0) - 1.0;
+		x2 = 2.0 * generate(stream, 0.0, 1.0) - 1.0;
+		w = x1 * x1 + x2 * x2;
+	} while ( w >= 1.0 || w == 0.0 );
 
-		w = sqrt( (-2.0 * log( w ) ) / w );
-		y1 = x1 * w;
-		y2 = x2 * w;
-		use_last = 1;
-	}
-
-	return( m + y1 * s );
+	w = sqrt( (-2.0 * log( w ) ) / w );
+	return( m + x1 * w * s );
 }
 
 }
-}
\ No newline at end of file
+}
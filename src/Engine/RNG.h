@@ -19,27 +19,37 @@
 #ifndef OPENXCOM_RNG_H
 #define OPENXCOM_RNG_H
 
+#include <yaml-cpp/yaml.h>
+
 namespace OpenXcom
 {
 
 /**
  * Random Number Generator used throughout the game
- * for all your randomness needs. It's really just the
- * standard C generator, but wrapped in a way that we
- * can store its seed for later use if necessary.
+ * for all your randomness needs. Each part of the game
+ * draws from its own xoshiro128** stream, so eg. the AI
+ * rolling more dice doesn't change what the map generator
+ * does, and the state of every stream goes in the save.
  */
 namespace RNG
 {
+	/// Independent random streams, one per subsystem.
+	enum RNGStream { STREAM_GEOSCAPE, STREAM_MAPGEN, STREAM_AI, STREAM_COMBAT, STREAM_COSMETIC, STREAM_TOTAL };
+
 	/// Initializes the generator.
 	void init(int seed = -1);
 	/// Gets the generator's seed.
 	int getSeed();
+	/// Loads the generator state from YAML.
+	void load(const YAML::Node& node);
+	/// Saves the generator state to YAML.
+	void save(YAML::Emitter& out);
 	/// Generates a random integer number.
-	int generate(int min, int max);
+	int generate(RNGStream stream, int min, int max);
 	/// Generates a random decimal number.
-	double generate(double min, double max);
+	double generate(RNGStream stream, double min, double max);
 	/// Get normally distributed value.
-	double boxMuller(double m = 0, double s = 1);
+	double boxMuller(RNGStream stream, double m = 0, double s = 1);
 }
 
 }
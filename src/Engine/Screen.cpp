@@ -19,13 +19,18 @@
 #include "Screen.h"
 #include <sstream>
 #include <iomanip>
-#include <SDL_rotozoom.h>
+#include <cstring>
 #include "Exception.h"
 #include "Surface.h"
 #include "Action.h"
 #include "Options.h"
 #include "CrossPlatform.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZOOM_SSE2
+#endif
+
 namespace OpenXcom
 {
 
@@ -38,7 +43,7 @@ const double Screen::BASE_HEIGHT = 200.0;
  * @param height Height in pixels.
  * @param bpp Bits-per-pixel.
  */
-Screen::Screen(int width, int height, int bpp) : _scaleX(1.0), _scaleY(1.0), _fullscreen(false)
+Screen::Screen(int width, int height, int bpp) : _scaleX(1.0), _scaleY(1.0), _fullscreen(false), _zoomWidth(0), _zoomHeight(0), _zoomColumns(), _zoomRows()
 {
 	_flags = SDL_SWSURFACE|SDL_HWPALETTE;
 	_screen = SDL_SetVideoMode(width, height, bpp, _flags);
@@ -47,6 +52,7 @@ Screen::Screen(int width, int height, int bpp) : _scaleX(1.0), _scaleY(1.0), _fu
 		throw Exception(SDL_GetError());
 	}
 	_surface = new Surface(width, height);
+	mapColors(0, 256);
 }
 
 /**
@@ -94,117 +100,249 @@ void Screen::handle(Action *action)
 }
 
 /**
- * Internal 8 bit Zoomer without smoothing.
- * Source code originally from SDL_gfx (LGPL) with permission by author.
- *
- * Zooms 8bit palette/Y 'src' surface to 'dst' surface.
- * Assumes src and dst surfaces are of 8 bit depth.
- * Assumes dst surface was allocated with the correct dimensions.
- *
- * @param src The surface to zoom (input).
- * @param dst The zoomed surface (output).
- * @param flipx Flag indicating if the image should be horizontally flipped.
- * @param flipy Flag indicating if the image should be vertically flipped.
- * @return 0 for success or -1 for error.
+ * Enlarges a row of 8bpp pixels by an integer factor,
+ * duplicating every pixel that many times.
+ * @param src Source row.
+ * @param dst Destination row.
+ * @param width Width of the source row in pixels.
+ * @param factor Scaling factor (2-4).
  */
-int Screen::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy)
+static void expandRow8(const Uint8 *src, Uint8 *dst, int width, int factor)
 {
-	int x, y;
-	Uint32 *sax, *say, *csax, *csay;
-	int csx, csy;
-	Uint8 *sp, *dp, *csp;
-	int dgap;
-
-	/*
-	* Allocate memory for row increments
-	*/
-	if ((sax = (Uint32 *) malloc((dst->w + 1) * sizeof(Uint32))) == NULL) {
-		return (-1);
-	}
-	if ((say = (Uint32 *) malloc((dst->h + 1) * sizeof(Uint32))) == NULL) {
-		free(sax);
-		return (-1);
+	int x = 0;
+	switch (factor)
+	{
+	case 2:
+#ifdef ZOOM_SSE2
+		for (; x + 16 <= width; x += 16, dst += 32)
+		{
+			__m128i v = _mm_loadu_si128((const __m128i*)(src + x));
+			_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi8(v, v));
+			_mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi8(v, v));
+		}
+#endif
+		for (; x < width; ++x, dst += 2)
+		{
+			dst[0] = dst[1] = src[x];
+		}
+		break;
+	case 3:
+		for (; x < width; ++x, dst += 3)
+		{
+			dst[0] = dst[1] = dst[2] = src[x];
+		}
+		break;
+	case 4:
+#ifdef ZOOM_SSE2
+		for (; x + 16 <= width; x += 16, dst += 64)
+		{
+			__m128i v = _mm_loadu_si128((const __m128i*)(src + x));
+			__m128i lo = _mm_unpacklo_epi8(v, v);
+			__m128i hi = _mm_unpackhi_epi8(v, v);
+			_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi16(lo, lo));
+			_mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi16(lo, lo));
+			_mm_storeu_si128((__m128i*)(dst + 32), _mm_unpacklo_epi16(hi, hi));
+			_mm_storeu_si128((__m128i*)(dst + 48), _mm_unpackhi_epi16(hi, hi));
+		}
+#endif
+		for (; x < width; ++x, dst += 4)
+		{
+			dst[0] = dst[1] = dst[2] = dst[3] = src[x];
+		}
+		break;
 	}
+}
 
-	/*
-	* Pointer setup
-	*/
-	sp = csp = (Uint8 *) src->pixels;
-	dp = (Uint8 *) dst->pixels;
-	dgap = dst->pitch - dst->w;
+/**
+ * Enlarges a row of 8bpp pixels by an integer factor
+ * while converting them to display pixels.
+ * @param src Source row.
+ * @param dst Destination row.
+ * @param width Width of the source row in pixels.
+ * @param factor Scaling factor.
+ * @param colors Display value of every palette color.
+ */
+template <typename Pixel>
+static void expandRow(const Uint8 *src, Pixel *dst, int width, int factor, const Uint32 *colors)
+{
+	for (int x = 0; x < width; ++x)
+	{
+		Pixel c = (Pixel)colors[src[x]];
+		for (int i = 0; i < factor; ++i)
+		{
+			*dst++ = c;
+		}
+	}
+}
 
-	if (flipx) csp += (src->w-1);
-	if (flipy) csp  = ( (Uint8*)csp + src->pitch*(src->h-1) );
+/**
+ * Scales a row of 8bpp pixels by any factor
+ * while converting them to display pixels.
+ * @param src Source row.
+ * @param dst Destination row.
+ * @param columns Source column of every destination pixel.
+ * @param width Width of the destination row in pixels.
+ * @param colors Display value of every palette color.
+ */
+template <typename Pixel>
+static void scaleRow(const Uint8 *src, Pixel *dst, const int *columns, int width, const Uint32 *colors)
+{
+	for (int x = 0; x < width; ++x)
+	{
+		dst[x] = (Pixel)colors[src[columns[x]]];
+	}
+}
 
-	/*
-	* Precalculate row increments
-	*/
-	csx = 0;
-	csax = sax;
-	for (x = 0; x < dst->w; x++) {
-		csx += src->w;
-		*csax = 0;
-		while (csx >= dst->w) {
-			csx -= dst->w;
-			(*csax)++;
+/**
+ * Scales the rows of an 8bpp surface onto the display surface.
+ * Destination rows sampling the same source row as the previous
+ * one are just copied over.
+ * @param src The surface to zoom (input).
+ * @param dst The zoomed surface (output).
+ * @param columns Source column of every destination pixel.
+ * @param rows Source row of every destination row.
+ * @param colors Display value of every palette color.
+ */
+template <typename Pixel>
+static void zoomRows(SDL_Surface *src, SDL_Surface *dst, const int *columns, const int *rows, const Uint32 *colors)
+{
+	const Uint8 *srcPixels = (const Uint8*)src->pixels;
+	Uint8 *dstPixels = (Uint8*)dst->pixels;
+	size_t rowSize = dst->w * sizeof(Pixel);
+	int factor = (dst->w % src->w == 0) ? dst->w / src->w : 0;
+	for (int y = 0; y < dst->h; ++y)
+	{
+		Pixel *row = (Pixel*)(dstPixels + y * dst->pitch);
+		if (y > 0 && rows[y] == rows[y - 1])
+		{
+			memcpy(row, dstPixels + (y - 1) * dst->pitch, rowSize);
+			continue;
 		}
-		(*csax) *= (flipx ? -1 : 1);
-		csax++;
-	}
-	csy = 0;
-	csay = say;
-	for (y = 0; y < dst->h; y++) {
-		csy += src->h;
-		*csay = 0;
-		while (csy >= dst->h) {
-			csy -= dst->h;
-			(*csay)++;
+		const Uint8 *srcRow = srcPixels + rows[y] * src->pitch;
+		if (factor != 0)
+		{
+			expandRow<Pixel>(srcRow, row, src->w, factor, colors);
+		}
+		else
+		{
+			scaleRow<Pixel>(srcRow, row, columns, dst->w, colors);
 		}
-		(*csay) *= src->pitch * (flipy ? -1 : 1);
-		csay++;
 	}
+}
 
-	/*
-	* Draw
-	*/
-	csay = say;
-	for (y = 0; y < dst->h; y++) {
-		csax = sax;
-		sp = csp;
-		for (x = 0; x < dst->w; x++) {
-			/*
-			* Draw
-			*/
-			*dp = *sp;
-			/*
-			* Advance source pointers
-			*/
-			sp += (*csax);
-			csax++;
-			/*
-			* Advance destination pointer
-			*/
-			dp++;
+/**
+ * 8bpp rows don't need any color conversion, and common
+ * integer factors have their own specialized paths.
+ */
+template <>
+void zoomRows<Uint8>(SDL_Surface *src, SDL_Surface *dst, const int *columns, const int *rows, const Uint32 *colors)
+{
+	const Uint8 *srcPixels = (const Uint8*)src->pixels;
+	Uint8 *dstPixels = (Uint8*)dst->pixels;
+	int factor = (dst->w % src->w == 0) ? dst->w / src->w : 0;
+	for (int y = 0; y < dst->h; ++y)
+	{
+		Uint8 *row = dstPixels + y * dst->pitch;
+		if (y > 0 && rows[y] == rows[y - 1])
+		{
+			memcpy(row, row - dst->pitch, dst->w);
+			continue;
 		}
-		/*
-		* Advance source pointer (for row)
-		*/
-		csp += (*csay);
-		csay++;
+		const Uint8 *srcRow = srcPixels + rows[y] * src->pitch;
+		if (factor == 1)
+		{
+			memcpy(row, srcRow, dst->w);
+		}
+		else if (factor >= 2 && factor <= 4)
+		{
+			expandRow8(srcRow, row, src->w, factor);
+		}
+		else
+		{
+			for (int x = 0; x < dst->w; ++x)
+			{
+				row[x] = srcRow[columns[x]];
+			}
+		}
+	}
+}
 
-		/*
-		* Advance destination pointers
-		*/
-		dp += dgap;
+/**
+ * Recalculates which source pixel is sampled by every
+ * destination pixel. This only needs to be done when
+ * the resolution changes, not on every frame.
+ */
+void Screen::updateZoom()
+{
+	SDL_Surface *src = _surface->getSurface();
+	if (_zoomWidth == _screen->w && _zoomHeight == _screen->h)
+		return;
+	_zoomWidth = _screen->w;
+	_zoomHeight = _screen->h;
+
+	_zoomColumns.resize(_zoomWidth);
+	for (int x = 0; x < _zoomWidth; ++x)
+	{
+		_zoomColumns[x] = x * src->w / _zoomWidth;
 	}
+	_zoomRows.resize(_zoomHeight);
+	for (int y = 0; y < _zoomHeight; ++y)
+	{
+		_zoomRows[y] = y * src->h / _zoomHeight;
+	}
+}
 
-	/*
-	* Remove temp arrays
-	*/
-	free(sax);
-	free(say);
+/**
+ * Converts a range of palette colors into
+ * the pixel values used by the display screen,
+ * so they can be written directly while scaling.
+ * @param firstcolor Offset of the first color to convert.
+ * @param ncolors Amount of colors to convert.
+ */
+void Screen::mapColors(int firstcolor, int ncolors)
+{
+	SDL_Color *palette = getPalette();
+	for (int i = firstcolor; i < firstcolor + ncolors && i < 256; ++i)
+	{
+		if (_screen->format->BytesPerPixel == 1)
+		{
+			_colors[i] = i;
+		}
+		else
+		{
+			_colors[i] = SDL_MapRGB(_screen->format, palette[i].r, palette[i].g, palette[i].b);
+		}
+	}
+}
 
-	return (0);
+/**
+ * Zooms the 8bpp 'src' surface to the 'dst' display surface without
+ * smoothing, converting the pixels to the display format in the same pass.
+ * Assumes dst surface was allocated with the correct dimensions.
+ * @param src The surface to zoom (input).
+ * @param dst The zoomed surface (output).
+ */
+void Screen::zoomSurface(SDL_Surface *src, SDL_Surface *dst)
+{
+	updateZoom();
+	if (SDL_MUSTLOCK(dst) && SDL_LockSurface(dst) < 0)
+		return;
+	switch (dst->format->BytesPerPixel)
+	{
+	case 1:
+		zoomRows<Uint8>(src, dst, &_zoomColumns[0], &_zoomRows[0], _colors);
+		break;
+	case 2:
+		zoomRows<Uint16>(src, dst, &_zoomColumns[0], &_zoomRows[0], _colors);
+		break;
+	case 4:
+		zoomRows<Uint32>(src, dst, &_zoomColumns[0], &_zoomRows[0], _colors);
+		break;
+	default:
+		break;
+	}
+	if (SDL_MUSTLOCK(dst))
+		SDL_UnlockSurface(dst);
 }
 
 /**
@@ -218,7 +356,7 @@ void Screen::flip()
 {
 	if (getWidth() != BASE_WIDTH || getHeight() != BASE_HEIGHT)
 	{
-		_zoomSurfaceY(_surface->getSurface(), _screen, 0, 0);
+		zoomSurface(_surface->getSurface(), _screen);
 	}
 	else
 	{
@@ -255,6 +393,7 @@ void Screen::setPalette(SDL_Color* colors, int firstcolor, int ncolors)
 {
 	_surface->setPalette(colors, firstcolor, ncolors);
 	SDL_SetColors(_screen, colors, firstcolor, ncolors);
+	mapColors(firstcolor, ncolors);
 }
 
 /**
@@ -19,6 +19,7 @@
 #ifndef OPENXCOM_SCREEN_H
 #define OPENXCOM_SCREEN_H
 
+#include <vector>
 #include <SDL.h>
 
 namespace OpenXcom
@@ -45,7 +46,15 @@ private:
 	double _scaleX, _scaleY;
 	Uint32 _flags;
 	bool _fullscreen;
-	int _zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy);
+	int _zoomWidth, _zoomHeight;
+	std::vector<int> _zoomColumns, _zoomRows;
+	Uint32 _colors[256];
+	/// Recalculates the scaling tables for the current resolution.
+	void updateZoom();
+	/// Converts the palette to display pixel values.
+	void mapColors(int firstcolor, int ncolors);
+	/// Scales the buffer onto the display screen.
+	void zoomSurface(SDL_Surface *src, SDL_Surface *dst);
 public:
 	/// Creates a new display screen with the specified resolution.
 	Screen(int width, int height, int bpp);
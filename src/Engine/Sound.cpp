@@ -18,6 +18,8 @@
  */
 #include "Sound.h"
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
 #include <SDL.h>
 #include "Exception.h"
 #include "Options.h"
@@ -68,6 +70,60 @@ void Sound::load(const void *data, unsigned int size)
 	}
 }
 
+/**
+ * Loads a sound from raw unsigned 8-bit mono samples with no
+ * WAV header. The samples are converted straight into the
+ * mixer's format, so no header has to be put in front of them.
+ * @param data Pointer to the samples in memory.
+ * @param size Size of the samples in bytes.
+ * @param frequency Sample rate in Hz.
+ */
+void Sound::loadRaw(const void *data, unsigned int size, int frequency)
+{
+	int outFrequency, outChannels;
+	Uint16 outFormat;
+	if (Mix_QuerySpec(&outFrequency, &outFormat, &outChannels) == 0)
+	{
+		throw Exception(Mix_GetError());
+	}
+
+	SDL_AudioCVT cvt;
+	if (SDL_BuildAudioCVT(&cvt, AUDIO_U8, 1, frequency, outFormat, outChannels, outFrequency) < 0)
+	{
+		throw Exception(SDL_GetError());
+	}
+
+	// The conversion is done in place, in a buffer big enough for the result
+	cvt.len = size;
+	cvt.buf = (Uint8*)malloc(size * cvt.len_mult);
+	if (cvt.buf == 0)
+	{
+		throw Exception("Out of memory");
+	}
+	memcpy(cvt.buf, data, size);
+	if (cvt.needed)
+	{
+		if (SDL_ConvertAudio(&cvt) < 0)
+		{
+			free(cvt.buf);
+			throw Exception(SDL_GetError());
+		}
+	}
+	else
+	{
+		cvt.len_cvt = size;
+	}
+
+	_sound = Mix_QuickLoad_RAW(cvt.buf, cvt.len_cvt);
+	if (_sound == 0)
+	{
+		free(cvt.buf);
+		throw Exception(Mix_GetError());
+	}
+	// Let Mix_FreeChunk free the samples along with the chunk
+	_sound->allocated = 1;
+}
+
 /**
  * Plays the contained sound effect.
  */
@@ -42,6 +42,8 @@ public:
 	void load(const std::string &filename);
 	/// Loads sound from a chunk of memory.
 	void load(const void *data, unsigned int size);
+	/// Loads sound from raw 8-bit mono samples.
+	void loadRaw(const void *data, unsigned int size, int frequency);
 	/// Plays the sound.
 	void play() const;
 };
@@ -61,31 +61,12 @@ void SoundSet::loadCat(const std::string &filename, bool wav)
 		throw Exception("Failed to load CAT");
 	}
 
-	// Load each sound file
+	// Load each sound file straight from the CAT
 	for (int i = 0; i < sndFile.getAmount(); ++i)
 	{
-		// Read WAV chunk
-		char *sound = sndFile.load(i);
+		const char *sound = sndFile.getObject(i);
 		unsigned int size = sndFile.getObjectSize(i);
 
-		// If there's no WAV header (44 bytes), add it
-		// Assuming sounds are 8-bit 8000Hz (DOS version)
-		char *newsound = 0;
-		if (!wav)
-		{
-			char header[] = {'R', 'I', 'F', 'F', 0x00, 0x00, 0x00, 0x00, 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ',
-							 0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x40, 0x1f, 0x00, 0x00, 0x40, 0x1f, 0x00, 0x00, 0x01, 0x00, 0x08, 0x00,
-							 'd', 'a', 't', 'a', 0x00, 0x00, 0x00, 0x00};
-			int headersize = size + 36;
-			int soundsize = size;
-			memcpy(header + 4, &headersize, sizeof(headersize));
-			memcpy(header + 40, &soundsize, sizeof(soundsize));
-
-			newsound = new char[44 + size];
-			memcpy(newsound, header, 44);
-			memcpy(newsound + 44, sound, size);
-		}
-
 		Sound *s = new Sound();
 		try
 		{
@@ -93,10 +74,12 @@ void SoundSet::loadCat(const std::string &filename, bool wav)
 			{
 				throw Exception("Invalid sound file");
 			}
+			// If there's no WAV header, the samples are
+			// 8-bit 8000Hz mono (DOS version)
 			if (wav)
 				s->load(sound, size);
 			else
-				s->load(newsound, 44 + size);
+				s->loadRaw(sound, size, 8000);
 		}
 		catch (Exception &e)
 		{
@@ -104,12 +87,6 @@ void SoundSet::loadCat(const std::string &filename, bool wav)
 			e = e;
 		}
 		_sounds.push_back(s);
-
-		delete[] sound;
-		if (!wav)
-		{
-			delete[] newsound;
-		}
 	}
 }
 
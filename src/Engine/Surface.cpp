@@ -18,11 +18,15 @@
  */
 #include "Surface.h"
 #include "ShaderDraw.h"
-#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
 #include <SDL_gfxPrimitives.h>
 #include "Palette.h"
 #include "Exception.h"
 #include "ShaderMove.h"
+#include "CrossPlatform.h"
+#include "AssetCache.h"
 
 namespace OpenXcom
 {
@@ -92,8 +96,8 @@ Surface::~Surface()
 void Surface::loadScr(const std::string &filename)
 {
 	// Load file and put pixels in surface
-	std::ifstream imgFile (filename.c_str(), std::ios::in | std::ios::binary);
-	if (!imgFile)
+	std::vector<unsigned char> data;
+	if (!CrossPlatform::readFile(filename, &data))
 	{
 		throw Exception("Failed to load SCR");
 	}
@@ -101,23 +105,14 @@ void Surface::loadScr(const std::string &filename)
 	// Lock the surface
 	lock();
 
-	Uint8 value;
 	int x = 0, y = 0;
-
-	while (imgFile.read((char*)&value, 1))
-	{
-		setPixelIterative(&x, &y, value);
-	}
-
-	if (!imgFile.eof())
+	if (!data.empty())
 	{
-		throw Exception("Invalid data from file");
+		setPixelsIterative(&x, &y, &data[0], data.size());
 	}
 
 	// Unlock the surface
 	unlock();
-
-	imgFile.close();
 }
 
 /**
@@ -129,9 +124,19 @@ void Surface::loadScr(const std::string &filename)
  */
 void Surface::loadSpk(const std::string &filename)
 {
+	// Decoded images are cached, use that if it's still valid
+	std::vector<unsigned char> data;
+	int x = 0, y = 0;
+	if (AssetCache::load(filename, filename, &data) && data.size() == (size_t)(getWidth() * getHeight()))
+	{
+		lock();
+		setPixelsIterative(&x, &y, &data[0], data.size());
+		unlock();
+		return;
+	}
+
 	// Load file and put pixels in surface
-	std::ifstream imgFile (filename.c_str(), std::ios::in | std::ios::binary);
-	if (!imgFile)
+	if (!CrossPlatform::readFile(filename, &data))
 	{
 		throw Exception("Failed to load SPK");
 	}
@@ -139,35 +144,37 @@ void Surface::loadSpk(const std::string &filename)
 	// Lock the surface
 	lock();
 
-	Uint16 flag;
-	Uint8 value;
-	int x = 0, y = 0;
+	size_t i = 0, size = data.size();
 
-	while (imgFile.read((char*)&flag, sizeof(flag)) && flag != 65533)
+	while (i + 2 <= size)
 	{
+		Uint16 flag = data[i] | (data[i + 1] << 8);
+		i += 2;
+		if (flag == 65533 || i + 2 > size)
+		{
+			break;
+		}
+		int count = (data[i] | (data[i + 1] << 8)) * 2;
 		if (flag == 65535)
 		{
-			imgFile.read((char*)&flag, sizeof(flag));
-			for (int i = 0; i < flag * 2; ++i)
-			{
-				setPixelIterative(&x, &y, 0);
-			}
+			i += 2;
+			setPixelsIterative(&x, &y, 0, count);
 		}
 		else if (flag == 65534)
 		{
-			imgFile.read((char*)&flag, sizeof(flag));
-			for (int i = 0; i < flag * 2; ++i)
-			{
-				imgFile.read((char*)&value, 1);
-				setPixelIterative(&x, &y, value);
-			}
+			i += 2;
+			count = std::min(count, (int)(size - i));
+			setPixelsIterative(&x, &y, &data[i], count);
+			i += count;
 		}
 	}
 
 	// Unlock the surface
 	unlock();
 
-	imgFile.close();
+	data.resize(getWidth() * getHeight());
+	getPixels(&data[0]);
+	AssetCache::save(filename, filename, data);
 }
 
 /**
@@ -535,6 +542,47 @@ void Surface::setPixelIterative(int *x, int *y, Uint8 pixel)
 	}
 }
 
+/**
+ * Changes a run of pixels in the surface and returns the next
+ * pixel position, same as setPixelIterative but copying whole
+ * rows at once. Used by the image decoders.
+ * @param x Pointer to the X position of the first pixel. Changed to the next X position in the sequence.
+ * @param y Pointer to the Y position of the first pixel. Changed to the next Y position in the sequence.
+ * @param pixels Array of new colors, or 0 to clear the pixels.
+ * @param count Number of pixels to change.
+ */
+void Surface::setPixelsIterative(int *x, int *y, const Uint8 *pixels, int count)
+{
+	int width = getWidth(), height = getHeight();
+	while (count > 0)
+	{
+		int n = std::min(count, width - *x);
+		if (*y >= 0 && *y < height)
+		{
+			Uint8 *dest = (Uint8 *)_surface->pixels + *y * _surface->pitch + *x;
+			if (pixels)
+			{
+				memcpy(dest, pixels, n);
+			}
+			else
+			{
+				memset(dest, 0, n);
+			}
+		}
+		if (pixels)
+		{
+			pixels += n;
+		}
+		count -= n;
+		*x += n;
+		if (*x == width)
+		{
+			(*y)++;
+			*x = 0;
+		}
+	}
+}
+
 /**
  * Returns the color of a specified pixel in the surface.
  * @param x X position of the pixel.
@@ -546,6 +594,19 @@ Uint8 Surface::getPixel(int x, int y) const
 	return ((Uint8 *)_surface->pixels)[y * _surface->pitch + x * _surface->format->BytesPerPixel];
 }
 
+/**
+ * Copies the surface's pixels row by row into a buffer,
+ * without any padding between rows.
+ * @param pixels Pointer to a buffer of width * height bytes.
+ */
+void Surface::getPixels(Uint8 *pixels) const
+{
+	for (int y = 0; y < getHeight(); ++y)
+	{
+		memcpy(pixels + y * getWidth(), (Uint8 *)_surface->pixels + y * _surface->pitch, getWidth());
+	}
+}
+
 /**
  * Returns the internal SDL_Surface for SDL calls.
  * @return Pointer to the surface.
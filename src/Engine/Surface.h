@@ -101,8 +101,12 @@ public:
 	void setPixel(int x, int y, Uint8 pixel);
 	/// Changes a pixel in the surface and returns the next one.
 	void setPixelIterative(int *x, int *y, Uint8 pixel);
+	/// Sets a run of pixels of the surface and moves to the next one.
+	void setPixelsIterative(int *x, int *y, const Uint8 *pixels, int count);
 	/// Gets a pixel of the surface.
 	Uint8 getPixel(int x, int y) const;
+	/// Copies all the pixels of the surface.
+	void getPixels(Uint8 *pixels) const;
 	/// Gets the internal SDL surface.
 	SDL_Surface *const getSurface() const;
 	/// Gets the surface's width.
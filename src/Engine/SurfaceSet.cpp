@@ -17,9 +17,11 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "SurfaceSet.h"
-#include <fstream>
+#include <vector>
 #include "Surface.h"
 #include "Exception.h"
+#include "CrossPlatform.h"
+#include "AssetCache.h"
 
 namespace OpenXcom
 {
@@ -72,74 +74,110 @@ SurfaceSet::~SurfaceSet()
 void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
 {
 	int nframes = 0;
+	int frameSize = _width * _height;
+
+	// Decoded frames are cached, use them if they're still valid
+	std::vector<unsigned char> data;
+	if (AssetCache::load(pck, pck, &data, tab) && !data.empty() && data.size() % frameSize == 0)
+	{
+		loadFrames(data);
+		return;
+	}
 
 	// Load TAB and get image offsets
-	std::ifstream offsetFile (tab.c_str(), std::ios::in | std::ios::binary);
-	if (!offsetFile)
+	std::vector<unsigned char> offsets;
+	if (!CrossPlatform::readFile(tab, &offsets))
 	{
 		nframes = 1;
-		Surface *surface = new Surface(_width, _height);
-		_frames.push_back(surface);
 	}
 	else
 	{
-		Uint16 off;
-
-		while (offsetFile.read((char*)&off, sizeof(off)))
-		{
-			Surface *surface = new Surface(_width, _height);
-			_frames.push_back(surface);
-			nframes++;
-		}
+		nframes = offsets.size() / sizeof(Uint16);
+	}
+	for (int i = 0; i < nframes; ++i)
+	{
+		Surface *surface = new Surface(_width, _height);
+		_frames.push_back(surface);
 	}
 
 	// Load PCX and put pixels in surfaces
-	std::ifstream imgFile (pck.c_str(), std::ios::in | std::ios::binary);
-	if (!imgFile)
+	if (!CrossPlatform::readFile(pck, &data))
 	{
 		throw Exception("Failed to load PCK");
 	}
 
-	Uint8 value;
+	size_t i = 0, size = data.size();
 
-	for (int frame = 0; frame < nframes; frame++)
+	for (int frame = 0; frame < nframes && i < size; frame++)
 	{
 		int x = 0, y = 0;
 
 		// Lock the surface
 		_frames[frame]->lock();
 
-		imgFile.read((char*)&value, 1);
-		for (int i = 0; i < value; ++i)
-		{
-			for (int j = 0; j < _width; ++j)
-			{
-				_frames[frame]->setPixelIterative(&x, &y, 0);
-			}
-		}
+		_frames[frame]->setPixelsIterative(&x, &y, 0, data[i++] * _width);
 
-		while (imgFile.read((char*)&value, 1) && value != 255)
+		while (i < size && data[i] != 255)
 		{
-			if (value == 254)
+			if (data[i] == 254)
 			{
-				imgFile.read((char*)&value, 1);
-				for (int i = 0; i < value; ++i)
+				if (i + 1 < size)
 				{
-					_frames[frame]->setPixelIterative(&x, &y, 0);
+					_frames[frame]->setPixelsIterative(&x, &y, 0, data[i + 1]);
 				}
+				i += 2;
 			}
 			else
 			{
-				_frames[frame]->setPixelIterative(&x, &y, value);
+				// Copy the whole run of literal pixels at once
+				size_t run = i;
+				while (run < size && data[run] < 254)
+				{
+					run++;
+				}
+				_frames[frame]->setPixelsIterative(&x, &y, &data[i], run - i);
+				i = run;
 			}
 		}
+		i++;
 
 		// Unlock the surface
 		_frames[frame]->unlock();
 	}
 
-	imgFile.close();
-	offsetFile.close();
+	data.resize(nframes * frameSize);
+	for (int frame = 0; frame < nframes; ++frame)
+	{
+		_frames[frame]->getPixels(&data[frame * frameSize]);
+	}
+	AssetCache::save(pck, pck, data, tab);
+}
+
+/**
+ * Splits a buffer of uncompressed pixels into frames,
+ * filling as many frames as it holds.
+ * @param data Pixels of every frame, one after another.
+ */
+void SurfaceSet::loadFrames(const std::vector<unsigned char> &data)
+{
+	int frameSize = _width * _height;
+	int nframes = (int)data.size() / frameSize;
+
+	for (int frame = 0; frame < nframes; ++frame)
+	{
+		Surface *surface = new Surface(_width, _height);
+		_frames.push_back(surface);
+
+		int x = 0, y = 0;
+
+		// Lock the surface
+		surface->lock();
+
+		surface->setPixelsIterative(&x, &y, &data[frame * frameSize], frameSize);
+
+		// Unlock the surface
+		surface->unlock();
+	}
 }
 
 /**
@@ -152,54 +190,14 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
  */
 void SurfaceSet::loadDat(const std::string &filename)
 {
-	int nframes = 0;
-
 	// Load file and put pixels in surface
-	std::ifstream imgFile (filename.c_str(), std::ios::in | std::ios::binary);
-	if (!imgFile)
+	std::vector<unsigned char> data;
+	if (!CrossPlatform::readFile(filename, &data))
 	{
 		throw Exception("Failed to load DAT");
 	}
 
-	imgFile.seekg(0, std::ios::end);
-	std::streamoff size = imgFile.tellg();
-	imgFile.seekg(0, std::ios::beg);
-
-	nframes = (int)size / (_width * _height);
-
-	for (int i = 0; i < nframes; ++i)
-	{
-		Surface *surface = new Surface(_width, _height);
-		_frames.push_back(surface);
-	}
-
-	Uint8 value;
-	int x = 0, y = 0, frame = 0;
-
-	// Lock the surface
-	_frames[frame]->lock();
-
-	while (imgFile.read((char*)&value, 1))
-	{
-		_frames[frame]->setPixelIterative(&x, &y, value);
-
-		if (y >= _height)
-		{
-			// Unlock the surface
-			_frames[frame]->unlock();
-
-			frame++;
-			x = 0;
-			y = 0;
-
-			if (frame >= nframes)
-				break;
-			else
-				_frames[frame]->lock();
-		}
-	}
-
-	imgFile.close();
+	loadFrames(data);
 }
 
 /**
@@ -39,6 +39,9 @@ class SurfaceSet
 private:
 	int _width, _height;
 	std::vector<Surface*> _frames;
+
+	/// Splits uncompressed pixels into frames.
+	void loadFrames(const std::vector<unsigned char> &data);
 public:
 	/// Crates a surface set with frames of the specified size.
 	SurfaceSet(int width, int height);
@@ -21,6 +21,11 @@
 namespace OpenXcom
 {
 
+Uint32 Timer::_nextDue = 0xFFFFFFFF;
+bool Timer::_fired = false;
+Uint32 Timer::_step = 0;
+Uint32 Timer::_clock = 0;
+
 /**
  * Initializes a new timer with a set interval.
  * @param interval Time interval in milliseconds.
@@ -41,7 +46,7 @@ Timer::~Timer()
  */
 void Timer::start()
 {
-	_start = SDL_GetTicks();
+	_start = getTicks();
 	_running = true;
 }
 
@@ -62,7 +67,7 @@ Uint32 Timer::getTime() const
 {
 	if (_running)
 	{
-		return SDL_GetTicks() - _start;
+		return getTicks() - _start;
 	}
 	return 0;
 }
@@ -79,6 +84,8 @@ bool Timer::isRunning() const
 /**
  * The timer keeps calculating the passed time while it's running,
  * calling the respective action handler whenever the set interval passes.
+ * It also keeps track of when it's due next, so the game knows
+ * how long it can sleep before any timer needs attention.
  * @param state State that the action handler belongs to.
  * @param surface Surface that the action handler belongs to.
  */
@@ -96,7 +103,12 @@ void Timer::think(State* state, Surface* surface)
 			{
 				(surface->*_surface)();
 			}
-			_start = SDL_GetTicks();
+			_start = getTicks();
+			_fired = true;
+		}
+		if (_running && _start + _interval < _nextDue)
+		{
+			_nextDue = _start + _interval;
 		}
 	}
 }
@@ -128,4 +140,60 @@ void Timer::onTimer(SurfaceHandler handler)
 	_surface = handler;
 }
 
+/**
+ * Clears the tracking of due and fired timers and moves
+ * the fixed step clock on, done at the start of every game cycle.
+ */
+void Timer::resetFrame()
+{
+	_nextDue = 0xFFFFFFFF;
+	_fired = false;
+	_clock += _step;
+}
+
+/**
+ * Returns the earliest time any of the timers advanced
+ * this game cycle is due to fire again.
+ * @return Time in milliseconds, or 0xFFFFFFFF if none.
+ */
+Uint32 Timer::getNextDue()
+{
+	return _nextDue;
+}
+
+/**
+ * Returns if any of the timers fired their
+ * action handler this game cycle.
+ * @return True if one did, False otherwise.
+ */
+bool Timer::hasFired()
+{
+	return _fired;
+}
+
+/**
+ * Makes all timers run off a clock that advances by a fixed
+ * amount every game cycle instead of the system clock, so
+ * the game plays out the same regardless of the frame rate.
+ * @param step Milliseconds per game cycle, 0 to use the system clock.
+ */
+void Timer::setFixedStep(Uint32 step)
+{
+	_step = step;
+	_clock = SDL_GetTicks();
+}
+
+/**
+ * Returns the current time the timers go by.
+ * @return Time in milliseconds.
+ */
+Uint32 Timer::getTicks()
+{
+	if (_step != 0)
+	{
+		return _clock;
+	}
+	return SDL_GetTicks();
+}
+
 }
@@ -37,6 +37,9 @@ typedef void (Surface::* SurfaceHandler)();
 class Timer
 {
 private:
+	static Uint32 _nextDue;
+	static bool _fired;
+	static Uint32 _step, _clock;
 	Uint32 _start, _interval;
 	bool _running;
 	StateHandler _state;
@@ -62,6 +65,16 @@ public:
 	void onTimer(StateHandler handler);
 	/// Hooks a surface action handler to the timer interval.
 	void onTimer(SurfaceHandler handler);
+	/// Resets the timer tracking for a new frame.
+	static void resetFrame();
+	/// Gets when the next timer advanced this frame is due.
+	static Uint32 getNextDue();
+	/// Gets if any timer fired this frame.
+	static bool hasFired();
+	/// Runs the timers on a fixed step per frame.
+	static void setFixedStep(Uint32 step);
+	/// Gets the time the timers go by.
+	static Uint32 getTicks();
 };
 
 }
@@ -116,7 +116,7 @@ void ConfirmDestinationState::btnOkClick(Action *action)
 		_game->getSavedGame()->getWaypoints()->push_back(w);
 	}
 	_craft->setDestination(_target);
-	_craft->setStatus("STR_OUT");
+	_craft->setStatus(CRAFT_OUT);
 	_game->popState();
 	_game->popState();
 }
@@ -28,6 +28,7 @@
 #include "../Interface/Text.h"
 #include "../Interface/TextButton.h"
 #include "../Savegame/SavedGame.h"
+#include "../Savegame/SavedBattleGame.h"
 #include "../Savegame/Craft.h"
 #include "../Savegame/Target.h"
 #include "../Savegame/Ufo.h"
@@ -45,7 +46,7 @@ namespace OpenXcom
  * @param texture Texture of the landing site.
  * @param shade Shade of the landing site.
  */
-ConfirmLandingState::ConfirmLandingState(Game *game, Craft *craft, int texture, int shade) : State(game), _craft(craft), _texture(texture), _shade(shade)
+ConfirmLandingState::ConfirmLandingState(Game *game, Craft *craft, int texture, int shade) : State(game), _craft(craft), _texture(texture), _shade(shade), _battleGame(0), _generator(0)
 {
 	_screen = false;
 
@@ -100,14 +101,35 @@ ConfirmLandingState::ConfirmLandingState(Game *game, Craft *craft, int texture,
 	_txtBegin->setBig();
 	_txtBegin->setAlign(ALIGN_CENTER);
 	_txtBegin->setText(_game->getLanguage()->getString("STR_BEGIN_MISSION"));
+
+	// get the battle ready while the player makes up their mind
+	Ufo* u = dynamic_cast<Ufo*>(_craft->getDestination());
+	if (u != 0)
+	{
+		_battleGame = new SavedBattleGame();
+		_battleGame->setMissionType("STR_UFO_CRASH_RECOVERY");
+		_generator = new BattlescapeGenerator(_game, _battleGame);
+		_generator->setWorldTexture(_texture);
+		_generator->setWorldShade(_shade);
+		_generator->setCraft(_craft);
+		_generator->setUfo(u);
+		_generator->setAlienRace("STR_SECTOID");
+		_generator->setAlienItemlevel(0);
+		_generator->start();
+	}
 }
 
 /**
- *
+ * Drops the battle if the player didn't go in.
  */
 ConfirmLandingState::~ConfirmLandingState()
 {
-
+	if (_generator != 0)
+	{
+		_generator->cancel();
+		delete _generator;
+		delete _battleGame;
+	}
 }
 
 /**
@@ -117,21 +139,14 @@ ConfirmLandingState::~ConfirmLandingState()
 void ConfirmLandingState::btnYesClick(Action *action)
 {
 	_game->popState();
-	Ufo* u = dynamic_cast<Ufo*>(_craft->getDestination());
-	if (u != 0)
+	if (_generator != 0)
 	{
-		SavedBattleGame *bgame = new SavedBattleGame();
-		_game->getSavedGame()->setBattleGame(bgame);
-		bgame->setMissionType("STR_UFO_CRASH_RECOVERY");
-		BattlescapeGenerator *bgen = new BattlescapeGenerator(_game);
-		bgen->setWorldTexture(_texture);
-		bgen->setWorldShade(_shade);
-		bgen->setCraft(_craft);
-		bgen->setUfo(u);
-		bgen->setAlienRace("STR_SECTOID");
-		bgen->setAlienItemlevel(0);
-		bgen->run();
-		delete bgen;
+		// usually done by now, otherwise wait for the rest
+		_generator->wait();
+		delete _generator;
+		_generator = 0;
+		_game->getSavedGame()->setBattleGame(_battleGame);
+		_battleGame = 0;
 
 		_game->pushState(new BriefingCrashState(_game, _craft));
 	}
@@ -143,6 +158,15 @@ void ConfirmLandingState::btnYesClick(Action *action)
  */
 void ConfirmLandingState::btnNoClick(Action *action)
 {
+	// stop the generator before the geoscape gets to run again
+	if (_generator != 0)
+	{
+		_generator->cancel();
+		delete _generator;
+		_generator = 0;
+		delete _battleGame;
+		_battleGame = 0;
+	}
 	_craft->returnToBase();
 	_game->popState();
 }
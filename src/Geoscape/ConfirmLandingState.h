@@ -28,6 +28,8 @@ class Window;
 class Text;
 class TextButton;
 class Craft;
+class SavedBattleGame;
+class BattlescapeGenerator;
 
 /**
  * Window that allows the player
@@ -41,6 +43,8 @@ private:
 	int _texture, _shade;
 	Text *_txtCraft, *_txtTarget, *_txtReady, *_txtBegin;
 	TextButton *_btnYes, *_btnNo;
+	SavedBattleGame *_battleGame;
+	BattlescapeGenerator *_generator;
 public:
 	/// Creates the Confirm Landing state.
 	ConfirmLandingState(Game *game, Craft *craft, int texture, int shade);
@@ -31,6 +31,7 @@
 #include "../Engine/Screen.h"
 #include "../Engine/Surface.h"
 #include "Globe.h"
+#include "RadarCoverage.h"
 #include "../Interface/Text.h"
 #include "../Interface/ImageButton.h"
 #include "../Engine/Timer.h"
@@ -300,7 +301,7 @@ void GeoscapeState::init()
 	if (!_music)
 	{
 		std::stringstream ss;
-		ss << "GMGEO" << RNG::generate(1, 2);
+		ss << "GMGEO" << RNG::generate(RNG::STREAM_GEOSCAPE, 1, 2);
 		_game->getResourcePack()->getMusic(ss.str())->play();
 		_music = true;
 	}
@@ -535,7 +536,7 @@ void GeoscapeState::time10Minutes()
 	{
 		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
 		{
-			if ((*j)->getStatus() == "STR_OUT")
+			if ((*j)->getStatus() == CRAFT_OUT)
 			{
 				(*j)->consumeFuel();
 				if (!(*j)->getLowFuel() && (*j)->getFuel() <= (*j)->getFuelLimit())
@@ -556,10 +557,10 @@ void GeoscapeState::time10Minutes()
 void GeoscapeState::time30Minutes()
 {
 	// Spawn UFOs
-	int chance = RNG::generate(1, 100);
+	int chance = RNG::generate(RNG::STREAM_GEOSCAPE, 1, 100);
 	if (chance <= 50)
 	{
-		int type = RNG::generate(1, 3);
+		int type = RNG::generate(RNG::STREAM_GEOSCAPE, 1, 3);
 		Ufo *u;
 		switch (type)
 		{
@@ -573,13 +574,13 @@ void GeoscapeState::time30Minutes()
 			u = new Ufo(_game->getRuleset()->getUfo("STR_LARGE_SCOUT"));
 			break;
 		}
-		u->setLongitude(RNG::generate(0.0, 2*M_PI));
-		u->setLatitude(RNG::generate(-M_PI_2, M_PI_2));
+		u->setLongitude(RNG::generate(RNG::STREAM_GEOSCAPE, 0.0, 2*M_PI));
+		u->setLatitude(RNG::generate(RNG::STREAM_GEOSCAPE, -M_PI_2, M_PI_2));
 		Waypoint *w = new Waypoint();
-		w->setLongitude(RNG::generate(0.0, 2*M_PI));
-		w->setLatitude(RNG::generate(-M_PI_2, M_PI_2));
+		w->setLongitude(RNG::generate(RNG::STREAM_GEOSCAPE, 0.0, 2*M_PI));
+		w->setLatitude(RNG::generate(RNG::STREAM_GEOSCAPE, -M_PI_2, M_PI_2));
 		u->setDestination(w);
-		u->setSpeed(RNG::generate(u->getRules()->getMaxSpeed() / 4, u->getRules()->getMaxSpeed() / 2));
+		u->setSpeed(RNG::generate(RNG::STREAM_GEOSCAPE, u->getRules()->getMaxSpeed() / 4, u->getRules()->getMaxSpeed() / 2));
 		_game->getSavedGame()->getUfos()->push_back(u);
 	}
 
@@ -588,7 +589,7 @@ void GeoscapeState::time30Minutes()
 	{
 		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
 		{
-			if ((*j)->getStatus() == "STR_REFUELLING")
+			if ((*j)->getStatus() == CRAFT_REFUELLING)
 			{
 				std::string item = (*j)->getRules()->getRefuelItem();
 				if (item == "")
@@ -605,7 +606,7 @@ void GeoscapeState::time30Minutes()
 					else
 					{
 						// TODO: No fuel popup
-						(*j)->setStatus("STR_READY");
+						(*j)->setStatus(CRAFT_READY);
 					}
 				}
 			}
@@ -613,59 +614,22 @@ void GeoscapeState::time30Minutes()
 	}
 
 	// Handle UFO detection
+	RadarCoverage radars(_game->getSavedGame()->getBases());
 	for (std::vector<Ufo*>::iterator u = _game->getSavedGame()->getUfos()->begin(); u != _game->getSavedGame()->getUfos()->end(); ++u)
 	{
 		if ((*u)->isCrashed())
 			continue;
 		if (!(*u)->getDetected())
 		{
-			bool detected = false;
-			for (std::vector<Base*>::iterator b = _game->getSavedGame()->getBases()->begin(); b != _game->getSavedGame()->getBases()->end() && !detected; ++b)
+			if (radars.detect(*u))
 			{
-				for (std::vector<BaseFacility*>::iterator f = (*b)->getFacilities()->begin(); f != (*b)->getFacilities()->end() && !detected; ++f)
-				{
-					if ((*f)->getBuildTime() != 0)
-						continue;
-					if ((*f)->insideRadarRange(*u))
-					{
-						int chance = RNG::generate(1, 100);
-						if (chance <= (*f)->getRules()->getRadarChance())
-						{
-							detected = true;
-						}
-					}
-				}
-				for (std::vector<Craft*>::iterator c = (*b)->getCrafts()->begin(); c != (*b)->getCrafts()->end() && !detected; ++c)
-				{
-					if ((*c)->getLongitude() == (*b)->getLongitude() && (*c)->getLatitude() == (*b)->getLatitude() && (*c)->getDestination() == 0)
-						continue;
-					if ((*c)->insideRadarRange(*u))
-					{
-						detected = true;
-					}
-				}
-			}
-			if (detected)
-			{
-				(*u)->setDetected(detected);
+				(*u)->setDetected(true);
 				popup(new UfoDetectedState(_game, (*u), this, true));
 			}
 		}
 		else
 		{
-			bool detected = false;
-			for (std::vector<Base*>::iterator b = _game->getSavedGame()->getBases()->begin(); b != _game->getSavedGame()->getBases()->end() && !detected; ++b)
-			{
-				for (std::vector<BaseFacility*>::iterator f = (*b)->getFacilities()->begin(); f != (*b)->getFacilities()->end() && !detected; ++f)
-				{
-					detected = detected || (*f)->insideRadarRange(*u);
-				}
-				for (std::vector<Craft*>::iterator c = (*b)->getCrafts()->begin(); c != (*b)->getCrafts()->end() && !detected; ++c)
-				{
-					detected = detected || (*c)->insideRadarRange(*u);
-				}
-			}
-			(*u)->setDetected(detected);
+			(*u)->setDetected(radars.track(*u));
 		}
 	}
 }
@@ -681,11 +645,11 @@ void GeoscapeState::time1Hour()
 	{
 		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
 		{
-			if ((*j)->getStatus() == "STR_REPAIRS")
+			if ((*j)->getStatus() == CRAFT_REPAIRS)
 			{
 				(*j)->repair();
 			}
-			else if ((*j)->getStatus() == "STR_REARMING")
+			else if ((*j)->getStatus() == CRAFT_REARMING)
 			{
 				std::string s = (*j)->rearm();
 				if (s != "")
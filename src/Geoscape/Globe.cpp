@@ -20,6 +20,7 @@
 #include "Globe.h"
 #include <cmath>
 #include <fstream>
+#include <algorithm>
 #include "../Engine/Action.h"
 #include "../Engine/SurfaceSet.h"
 #include "../Engine/Timer.h"
@@ -315,7 +316,7 @@ struct CreateShadow
  * @param x X position in pixels.
  * @param y Y position in pixels.
  */
-Globe::Globe(Game *game, int cenX, int cenY, int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _cenLon(0.0), _cenLat(0.0), _rotLon(0.0), _rotLat(0.0), _cenX(cenX), _cenY(cenY), _zoom(0), _game(game), _blink(true), _detail(true), _cacheLand()
+Globe::Globe(Game *game, int cenX, int cenY, int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _cenLon(0.0), _cenLat(0.0), _rotLon(0.0), _rotLat(0.0), _cenX(cenX), _cenY(cenY), _zoom(0), _game(game), _blink(true), _detail(true), _cacheLand(), _targets(), _targetGrid(), _gridWidth(0), _gridHeight(0), _targetCenLon(0.0), _targetCenLat(0.0), _targetZoom(0)
 {
 	_texture = new SurfaceSet(*_game->getResourcePack()->getSurfaceSet("TEXTURE.DAT"));
 
@@ -741,73 +742,174 @@ void Globe::toggleDetail()
 /**
  * Checks if a certain target is near a certain cartesian point
  * (within a circled area around it) over the globe.
- * @param target Pointer to target.
+ * @param target Cached target marker.
  * @param x X coordinate of point.
  * @param y Y coordinate of point.
  * @return True if it's near, false otherwise.
  */
-bool Globe::targetNear(Target* target, int x, int y) const
+bool Globe::targetNear(const GlobeMarker &target, int x, int y) const
 {
-	Sint16 tx, ty;
-	polarToCart(target->getLongitude(), target->getLatitude(), &tx, &ty);
-
-	int dx = x - tx;
-	int dy = y - ty;
+	int dx = x - target.x;
+	int dy = y - target.y;
 	return (dx * dx + dy * dy <= NEAR_RADIUS);
 }
 
 /**
- * Returns a list of all the targets currently near a certain
- * cartesian point over the globe.
+ * Returns the cell of the picking grid that contains
+ * a certain cartesian point. Points outside the globe
+ * fall into the nearest border cell.
  * @param x X coordinate of point.
  * @param y Y coordinate of point.
- * @param craft Only get craft targets.
- * @return List of pointers to targets.
+ * @return Cell index.
  */
-std::vector<Target*> Globe::getTargets(int x, int y, bool craft) const
+int Globe::getTargetCell(int x, int y) const
 {
-	std::vector<Target*> v;
-	if (!craft)
-	{
-		for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
-		{
-			if ((*i)->getLongitude() == 0.0 && (*i)->getLatitude() == 0.0)
-				continue;
+	int cx = (int)floor((double)x / MARKER_CELL);
+	int cy = (int)floor((double)y / MARKER_CELL);
+	cx = std::max(0, std::min(_gridWidth - 1, cx));
+	cy = std::max(0, std::min(_gridHeight - 1, cy));
+	return cy * _gridWidth + cx;
+}
 
-			if (targetNear((*i), x, y))
-			{
-				v.push_back(*i);
-			}
+/**
+ * Updates a target's entry in the marker cache, only
+ * projecting it again if it or the globe has moved.
+ * @param i Index of the entry.
+ * @param target Pointer to target.
+ * @param marker Marker to draw the target with.
+ * @param draw Is the marker drawn?
+ * @param pick Can the target be picked?
+ * @param destination Is the target a craft destination?
+ * @param moved Has the globe moved since the last cache?
+ * @param changed Pointer to flag set if the picking grid is outdated.
+ */
+void Globe::cacheTarget(size_t i, Target *target, Surface *marker, bool draw, bool pick, bool destination, bool moved, bool *changed)
+{
+	if (i == _targets.size())
+	{
+		_targets.push_back(GlobeMarker());
+	}
+	GlobeMarker &m = _targets[i];
+	if (moved || m.target != target || m.lon != target->getLongitude() || m.lat != target->getLatitude())
+	{
+		m.target = target;
+		m.lon = target->getLongitude();
+		m.lat = target->getLatitude();
+		m.back = pointBack(m.lon, m.lat);
+		polarToCart(m.lon, m.lat, &m.x, &m.y);
+		*changed = true;
+	}
+	if (m.pick != pick)
+	{
+		*changed = true;
+	}
+	m.marker = marker;
+	m.draw = draw;
+	m.pick = pick;
+	m.destination = destination;
+}
 
-			for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
-			{
-				if ((*j)->getLongitude() == (*i)->getLongitude() && (*j)->getLatitude() == (*i)->getLatitude() && (*j)->getDestination() == 0)
-					continue;
+/**
+ * Caches the screen positions of all the targets on the globe
+ * and sorts them into a grid for picking. Targets are only
+ * projected again when they or the globe move, so this is
+ * cheap to call whenever the markers are needed.
+ */
+void Globe::cacheTargets()
+{
+	bool moved = (_targetGrid.empty() || _cenLon != _targetCenLon || _cenLat != _targetCenLat || _zoom != _targetZoom);
+	bool changed = moved;
+	_targetCenLon = _cenLon;
+	_targetCenLat = _cenLat;
+	_targetZoom = _zoom;
 
-				if (targetNear((*j), x, y))
-				{
-					v.push_back(*j);
-				}
-			}
+	size_t n = 0;
+	for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
+	{
+		// Cheap hack to hide bases when they haven't been placed yet
+		bool placed = ((*i)->getLongitude() != 0.0 || (*i)->getLatitude() != 0.0);
+		cacheTarget(n++, *i, _mkXcomBase, placed, placed, false, moved, &changed);
+		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
+		{
+			// Hide crafts docked at base
+			bool out = ((*j)->getStatus() == CRAFT_OUT);
+			bool docked = ((*j)->getLongitude() == (*i)->getLongitude() && (*j)->getLatitude() == (*i)->getLatitude() && (*j)->getDestination() == 0);
+			cacheTarget(n++, *j, _mkCraft, out, !docked, false, moved, &changed);
 		}
 	}
 	for (std::vector<Ufo*>::iterator i = _game->getSavedGame()->getUfos()->begin(); i != _game->getSavedGame()->getUfos()->end(); ++i)
 	{
-		if (!(*i)->getDetected())
-			continue;
+		Surface *marker = (*i)->isCrashed() ? _mkCrashedUfo : _mkFlyingUfo;
+		cacheTarget(n++, *i, marker, (*i)->getDetected(), (*i)->getDetected(), true, moved, &changed);
+	}
+	for (std::vector<Waypoint*>::iterator i = _game->getSavedGame()->getWaypoints()->begin(); i != _game->getSavedGame()->getWaypoints()->end(); ++i)
+	{
+		cacheTarget(n++, *i, _mkWaypoint, true, true, true, moved, &changed);
+	}
+	if (n != _targets.size())
+	{
+		_targets.resize(n);
+		changed = true;
+	}
 
-		if (targetNear((*i), x, y))
+	if (changed)
+	{
+		_gridWidth = getWidth() / MARKER_CELL + 1;
+		_gridHeight = getHeight() / MARKER_CELL + 1;
+		_targetGrid.resize(_gridWidth * _gridHeight);
+		for (std::vector<std::vector<int> >::iterator i = _targetGrid.begin(); i != _targetGrid.end(); ++i)
+		{
+			i->clear();
+		}
+		for (size_t i = 0; i < _targets.size(); ++i)
 		{
-			v.push_back(*i);
+			if (_targets[i].pick)
+			{
+				_targetGrid[getTargetCell(_targets[i].x, _targets[i].y)].push_back(i);
+			}
 		}
 	}
-	for (std::vector<Waypoint*>::iterator i = _game->getSavedGame()->getWaypoints()->begin(); i != _game->getSavedGame()->getWaypoints()->end(); ++i)
+}
+
+/**
+ * Returns a list of all the targets currently near a certain
+ * cartesian point over the globe. Only the picking grid cells
+ * around the point are checked.
+ * @param x X coordinate of point.
+ * @param y Y coordinate of point.
+ * @param craft Only get craft targets.
+ * @return List of pointers to targets.
+ */
+std::vector<Target*> Globe::getTargets(int x, int y, bool craft)
+{
+	cacheTargets();
+
+	int radius = (int)ceil(sqrt((double)NEAR_RADIUS));
+	int cell1 = getTargetCell(x - radius, y - radius);
+	int cell2 = getTargetCell(x + radius, y + radius);
+	std::vector<int> near;
+	for (int cy = cell1 / _gridWidth; cy <= cell2 / _gridWidth; ++cy)
 	{
-		if (targetNear((*i), x, y))
+		for (int cx = cell1 % _gridWidth; cx <= cell2 % _gridWidth; ++cx)
 		{
-			v.push_back(*i);
+			std::vector<int> *cell = &_targetGrid[cy * _gridWidth + cx];
+			for (std::vector<int>::iterator i = cell->begin(); i != cell->end(); ++i)
+			{
+				if ((!craft || _targets[*i].destination) && targetNear(_targets[*i], x, y))
+				{
+					near.push_back(*i);
+				}
+			}
 		}
 	}
+	// Keep the targets in the same order they're listed in
+	std::sort(near.begin(), near.end());
+
+	std::vector<Target*> v;
+	for (std::vector<int>::iterator i = near.begin(); i != near.end(); ++i)
+	{
+		v.push_back(_targets[*i].target);
+	}
 	return v;
 }
 
@@ -1162,73 +1264,17 @@ void Globe::drawDetail()
  */
 void Globe::drawMarkers()
 {
-	Sint16 x, y;
 	_markers->clear();
+	cacheTargets();
 
-	// Draw the base markers
-	for (std::vector<Base*>::iterator i = _game->getSavedGame()->getBases()->begin(); i != _game->getSavedGame()->getBases()->end(); ++i)
-	{
-		// Cheap hack to hide bases when they haven't been placed yet
-		if (((*i)->getLongitude() != 0.0 || (*i)->getLatitude() != 0.0) &&
-			!pointBack((*i)->getLongitude(), (*i)->getLatitude()))
-		{
-			polarToCart((*i)->getLongitude(), (*i)->getLatitude(), &x, &y);
-
-			_mkXcomBase->setX(x - 1);
-			_mkXcomBase->setY(y - 1);
-			_mkXcomBase->blit(_markers);
-		}
-		// Draw the craft markers
-		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
-		{
-			// Hide crafts docked at base
-			if ((*j)->getStatus() != "STR_OUT" || pointBack((*j)->getLongitude(), (*j)->getLatitude()))
-				continue;
-
-			polarToCart((*j)->getLongitude(), (*j)->getLatitude(), &x, &y);
-
-			_mkCraft->setX(x - 1);
-			_mkCraft->setY(y - 1);
-			_mkCraft->blit(_markers);
-		}
-	}
-
-	// Draw the UFO markers
-	for (std::vector<Ufo*>::iterator i = _game->getSavedGame()->getUfos()->begin(); i != _game->getSavedGame()->getUfos()->end(); ++i)
+	for (std::vector<GlobeMarker>::iterator i = _targets.begin(); i != _targets.end(); ++i)
 	{
-		if (pointBack((*i)->getLongitude(), (*i)->getLatitude()))
+		if (!i->draw || i->back)
 			continue;
 
-		polarToCart((*i)->getLongitude(), (*i)->getLatitude(), &x, &y);
-
-		if ((*i)->getDetected())
-		{
-			if ((*i)->isCrashed())
-			{
-				_mkCrashedUfo->setX(x - 1);
-				_mkCrashedUfo->setY(y - 1);
-				_mkCrashedUfo->blit(_markers);
-			}
-			else
-			{
-				_mkFlyingUfo->setX(x - 1);
-				_mkFlyingUfo->setY(y - 1);
-				_mkFlyingUfo->blit(_markers);
-			}
-		}
-	}
-
-	// Draw the waypoint markers
-	for (std::vector<Waypoint*>::iterator i = _game->getSavedGame()->getWaypoints()->begin(); i != _game->getSavedGame()->getWaypoints()->end(); ++i)
-	{
-		if (pointBack((*i)->getLongitude(), (*i)->getLatitude()))
-			continue;
-
-		polarToCart((*i)->getLongitude(), (*i)->getLatitude(), &x, &y);
-
-		_mkWaypoint->setX(x - 1);
-		_mkWaypoint->setY(y - 1);
-		_mkWaypoint->blit(_markers);
+		i->marker->setX(i->x - 1);
+		i->marker->setY(i->y - 1);
+		i->marker->blit(_markers);
 	}
 }
 
@@ -33,6 +33,19 @@ class SurfaceSet;
 class Timer;
 class Target;
 
+/**
+ * Cached screen position of a target on the globe,
+ * along with how it's drawn and picked.
+ */
+struct GlobeMarker
+{
+	Target *target;
+	Surface *marker;
+	double lon, lat;
+	Sint16 x, y;
+	bool back, draw, pick, destination;
+};
+
 /**
  * Interactive globe view of the world.
  * Takes a flat world map made out of land polygons with
@@ -46,6 +59,7 @@ private:
 	static const int NUM_LANDSHADES = 48;
 	static const int NUM_SEASHADES = 72;
 	static const int NEAR_RADIUS = 25;
+	static const int MARKER_CELL = 16;
 	static const double QUAD_LONGITUDE;
 	static const double QUAD_LATITUDE;
 	static const double ROTATE_LONGITUDE;
@@ -62,6 +76,11 @@ private:
 	std::list<Polygon*> _cacheLand;
 	Surface *_mkXcomBase, *_mkAlienBase, *_mkCraft, *_mkWaypoint, *_mkCity;
 	Surface *_mkFlyingUfo, *_mkLandedUfo, *_mkCrashedUfo, *_mkAlienSite;
+	std::vector<GlobeMarker> _targets;
+	std::vector<std::vector<int> > _targetGrid;
+	int _gridWidth, _gridHeight;
+	double _targetCenLon, _targetCenLat;
+	size_t _targetZoom;
 
 	/// Checks if a point is behind the globe.
 	bool pointBack(double lon, double lat) const;
@@ -70,7 +89,13 @@ private:
 	/// Checks if a point is inside a polygon.
 	bool insidePolygon(double lon, double lat, Polygon *poly) const;
 	/// Checks if a target is near a point.
-	bool targetNear(Target* target, int x, int y) const;
+	bool targetNear(const GlobeMarker &target, int x, int y) const;
+	/// Updates a target in the marker cache.
+	void cacheTarget(size_t i, Target *target, Surface *marker, bool draw, bool pick, bool destination, bool moved, bool *changed);
+	/// Caches the screen positions of all the targets.
+	void cacheTargets();
+	/// Gets the picking grid cell of a point.
+	int getTargetCell(int x, int y) const;
 	/// Caches a set of polygons.
 	void cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache);
 	/// Get position of sun relative to given position in polar cords and date.
@@ -113,7 +138,7 @@ public:
 	/// Turns on/off the globe detail.
 	void toggleDetail();
 	/// Gets all the targets near a point on the globe.
-	std::vector<Target*> getTargets(int x, int y, bool craft) const;
+	std::vector<Target*> getTargets(int x, int y, bool craft);
 	/// Caches visible globe polygons.
 	void cachePolygons();
 	/// Sets the palette of the globe.
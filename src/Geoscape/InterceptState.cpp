@@ -137,8 +137,8 @@ InterceptState::InterceptState(Game *game, Globe *globe, Base *base) : State(gam
 				ss << (*j)->getNumVehicles();
 			}
 			_crafts.push_back(*j);
-			_lstCrafts->addRow(4, (*j)->getName(_game->getLanguage()).c_str(), _game->getLanguage()->getString((*j)->getStatus()).c_str(), (*i)->getName().c_str(), ss.str().c_str());
-			if ((*j)->getStatus() == "STR_READY")
+			_lstCrafts->addRow(4, (*j)->getName(_game->getLanguage()).c_str(), _game->getLanguage()->getString((*j)->getStatusString()).c_str(), (*i)->getName().c_str(), ss.str().c_str());
+			if ((*j)->getStatus() == CRAFT_READY)
 			{
 				_lstCrafts->setCellColor(row, 1, Palette::blockOffset(8)+10);
 			}
@@ -171,7 +171,7 @@ void InterceptState::btnCancelClick(Action *action)
 void InterceptState::lstCraftsClick(Action *action)
 {
 	Craft* c = _crafts[_lstCrafts->getSelectedRow()];
-	if (c->getStatus() != "STR_OUT" && (c->getStatus() == "STR_READY" || Options::getBool("craftLaunchAlways")))
+	if (c->getStatus() != CRAFT_OUT && (c->getStatus() == CRAFT_READY || Options::getBool("craftLaunchAlways")))
 	{
 		_game->popState();
 		_game->pushState(new SelectDestinationState(_game, c, _globe));
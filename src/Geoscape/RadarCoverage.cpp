@@ -0,0 +1,202 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define _USE_MATH_DEFINES
+#include "RadarCoverage.h"
+#include <cmath>
+#include <algorithm>
+#include "../Engine/RNG.h"
+#include "../Savegame/Base.h"
+#include "../Savegame/BaseFacility.h"
+#include "../Ruleset/RuleBaseFacility.h"
+#include "../Savegame/Craft.h"
+#include "../Ruleset/RuleCraft.h"
+#include "../Savegame/Ufo.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Builds the radar coverage of a list of bases. Each base
+ * becomes one circle merging the radars of all its facilities,
+ * and each craft out of its base becomes a circle of its own.
+ * Circles are added in the same order the bases, facilities and
+ * crafts are listed, so detection rolls happen in that order too.
+ * @param bases Pointer to list of bases.
+ */
+RadarCoverage::RadarCoverage(std::vector<Base*> *bases) : _circles(), _cells(CELLS_LAT * CELLS_LON)
+{
+	for (std::vector<Base*>::iterator b = bases->begin(); b != bases->end(); ++b)
+	{
+		std::vector<RadarBeam> beams;
+		double range = 0.0;
+		for (std::vector<BaseFacility*>::iterator f = (*b)->getFacilities()->begin(); f != (*b)->getFacilities()->end(); ++f)
+		{
+			if ((*f)->getRules()->getRadarRange() == 0)
+				continue;
+			double r = (*f)->getRules()->getRadarRange() * (1 / 60.0) * (M_PI / 180);
+			RadarBeam beam;
+			beam.cosRange = cos(r);
+			beam.chance = (*f)->getRules()->getRadarChance();
+			beam.discover = ((*f)->getBuildTime() == 0);
+			beams.push_back(beam);
+			range = std::max(range, r);
+		}
+		if (!beams.empty())
+		{
+			addCircle(*b, beams, range);
+		}
+
+		for (std::vector<Craft*>::iterator c = (*b)->getCrafts()->begin(); c != (*b)->getCrafts()->end(); ++c)
+		{
+			if ((*c)->getRules()->getRadarRange() == 0)
+				continue;
+			double r = (*c)->getRules()->getRadarRange() * (1 / 60.0) * (M_PI / 180);
+			RadarBeam beam;
+			beam.cosRange = cos(r);
+			beam.chance = -1;
+			// Crafts sitting in their base can't find anything new
+			beam.discover = !((*c)->getLongitude() == (*b)->getLongitude() && (*c)->getLatitude() == (*b)->getLatitude() && (*c)->getDestination() == 0);
+			addCircle(*c, std::vector<RadarBeam>(1, beam), r);
+		}
+	}
+}
+
+/**
+ *
+ */
+RadarCoverage::~RadarCoverage()
+{
+}
+
+/**
+ * Returns the grid cell that contains a point on the globe.
+ * @param lon Longitude in radian.
+ * @param lat Latitude in radian.
+ * @return Cell index.
+ */
+int RadarCoverage::getCell(double lon, double lat) const
+{
+	int y = (int)floor((lat + M_PI_2) / M_PI * CELLS_LAT);
+	int x = (int)floor(lon / (2 * M_PI) * CELLS_LON);
+	y = std::max(0, std::min(CELLS_LAT - 1, y));
+	x = ((x % CELLS_LON) + CELLS_LON) % CELLS_LON;
+	return y * CELLS_LON + x;
+}
+
+/**
+ * Adds a radar circle to the coverage and registers
+ * it in every grid cell its range reaches into.
+ * @param center Pointer to the target at the center of the circle.
+ * @param beams List of beams covered by the circle.
+ * @param range Largest range of the beams in radian.
+ */
+void RadarCoverage::addCircle(Target *center, const std::vector<RadarBeam> &beams, double range)
+{
+	double lon = center->getLongitude(), lat = center->getLatitude();
+	RadarCircle circle;
+	circle.x = cos(lat) * cos(lon);
+	circle.y = cos(lat) * sin(lon);
+	circle.z = sin(lat);
+	circle.cosRange = cos(range);
+	circle.beams = beams;
+	int id = _circles.size();
+	_circles.push_back(circle);
+
+	// Find the cells overlapped by the bounding box of the circle,
+	// with some leeway so rounding never misses a border cell
+	range += 1e-6;
+	int minY = (int)floor((lat - range + M_PI_2) / M_PI * CELLS_LAT);
+	int maxY = (int)floor((lat + range + M_PI_2) / M_PI * CELLS_LAT);
+	minY = std::max(0, minY);
+	maxY = std::min(CELLS_LAT - 1, maxY);
+	int minX = 0, maxX = CELLS_LON - 1;
+	if (lat - range > -M_PI_2 && lat + range < M_PI_2 && range < M_PI_2)
+	{
+		double dLon = asin(sin(range) / cos(lat));
+		minX = (int)floor((lon - dLon) / (2 * M_PI) * CELLS_LON);
+		maxX = (int)floor((lon + dLon) / (2 * M_PI) * CELLS_LON);
+		if (maxX - minX >= CELLS_LON)
+		{
+			minX = 0;
+			maxX = CELLS_LON - 1;
+		}
+	}
+	for (int y = minY; y <= maxY; ++y)
+	{
+		for (int x = minX; x <= maxX; ++x)
+		{
+			_cells[y * CELLS_LON + ((x % CELLS_LON) + CELLS_LON) % CELLS_LON].push_back(id);
+		}
+	}
+}
+
+/**
+ * Checks if a UFO not yet detected gets picked up by any radar
+ * in range. Base radars only have a chance of detecting it,
+ * while craft radars always detect it.
+ * @param ufo Pointer to UFO.
+ * @return True if it's detected, False otherwise.
+ */
+bool RadarCoverage::detect(Ufo *ufo) const
+{
+	double lon = ufo->getLongitude(), lat = ufo->getLatitude();
+	double x = cos(lat) * cos(lon), y = cos(lat) * sin(lon), z = sin(lat);
+	const std::vector<int> &cell = _cells[getCell(lon, lat)];
+	for (std::vector<int>::const_iterator i = cell.begin(); i != cell.end(); ++i)
+	{
+		const RadarCircle &circle = _circles[*i];
+		double dot = circle.x * x + circle.y * y + circle.z * z;
+		if (dot < circle.cosRange)
+			continue;
+		for (std::vector<RadarBeam>::const_iterator j = circle.beams.begin(); j != circle.beams.end(); ++j)
+		{
+			if (!j->discover || dot < j->cosRange)
+				continue;
+			if (j->chance < 0 || RNG::generate(RNG::STREAM_GEOSCAPE, 1, 100) <= j->chance)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/**
+ * Checks if an already detected UFO is still
+ * inside the range of any radar.
+ * @param ufo Pointer to UFO.
+ * @return True if it's in range, False otherwise.
+ */
+bool RadarCoverage::track(Ufo *ufo) const
+{
+	double lon = ufo->getLongitude(), lat = ufo->getLatitude();
+	double x = cos(lat) * cos(lon), y = cos(lat) * sin(lon), z = sin(lat);
+	const std::vector<int> &cell = _cells[getCell(lon, lat)];
+	for (std::vector<int>::const_iterator i = cell.begin(); i != cell.end(); ++i)
+	{
+		const RadarCircle &circle = _circles[*i];
+		if (circle.x * x + circle.y * y + circle.z * z >= circle.cosRange)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+}
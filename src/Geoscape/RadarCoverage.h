@@ -0,0 +1,84 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_RADARCOVERAGE_H
+#define OPENXCOM_RADARCOVERAGE_H
+
+#include <vector>
+
+namespace OpenXcom
+{
+
+class Base;
+class Ufo;
+class Target;
+
+/**
+ * A single radar beam centered on a radar circle,
+ * like one of the radar facilities in a base.
+ */
+struct RadarBeam
+{
+	double cosRange;
+	int chance;
+	bool discover;
+};
+
+/**
+ * Merged radar coverage of a single location on the globe,
+ * covering the combined range of all its beams.
+ */
+struct RadarCircle
+{
+	double x, y, z, cosRange;
+	std::vector<RadarBeam> beams;
+};
+
+/**
+ * Spatial index of the radar coverage of all the bases
+ * and airborne crafts on the globe. The globe is split
+ * into a grid of cells, and each cell knows which radar
+ * circles reach into it, so checking a UFO only needs
+ * to look at the radars near its own cell.
+ */
+class RadarCoverage
+{
+private:
+	static const int CELLS_LAT = 18, CELLS_LON = 36;
+
+	std::vector<RadarCircle> _circles;
+	std::vector<std::vector<int> > _cells;
+
+	/// Adds a radar circle to the coverage.
+	void addCircle(Target *center, const std::vector<RadarBeam> &beams, double range);
+	/// Gets the grid cell a point on the globe falls in.
+	int getCell(double lon, double lat) const;
+public:
+	/// Creates the radar coverage of a list of bases.
+	RadarCoverage(std::vector<Base*> *bases);
+	/// Cleans up the radar coverage.
+	~RadarCoverage();
+	/// Checks if a UFO gets detected by the radars.
+	bool detect(Ufo *ufo) const;
+	/// Checks if a UFO is inside any radar range.
+	bool track(Ufo *ufo) const;
+};
+
+}
+
+#endif
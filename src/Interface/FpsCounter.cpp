@@ -35,7 +35,7 @@ namespace OpenXcom
  * @param x X position in pixels.
  * @param y Y position in pixels.
  */
-FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, height, x, y), _frames(0)
+FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, height, x, y), _frames(0), _frameTime(0), _frameTimeMax(0), _averageFrameTime(0), _maxFrameTime(0)
 {
 	_visible = Options::getBool("fpsCounter");
 
@@ -91,25 +91,64 @@ void FpsCounter::handle(Action *action)
 }
 
 /**
- * Advances frame counter.
+ * Advances the FPS timer.
  */
 void FpsCounter::think()
 {
-	_frames++;
 	_timer->think(0, this);
 }
 
 /**
- * Updates the amount of Frames per Second.
+ * Counts a frame drawn to the screen, since the
+ * game doesn't draw anything when nothing changes.
+ * @param time Time taken by the frame in milliseconds.
+ */
+void FpsCounter::addFrame(Uint32 time)
+{
+	_frames++;
+	_frameTime += time;
+	if (time > _frameTimeMax)
+	{
+		_frameTimeMax = time;
+	}
+}
+
+/**
+ * Updates the amount of Frames per Second
+ * and the frame time statistics.
  */
 void FpsCounter::update()
 {
 	int fps = (int)floor((double)_frames / _timer->getTime() * 1000);
 	_text->setValue(fps);
+	_averageFrameTime = (_frames > 0) ? _frameTime / _frames : 0;
+	_maxFrameTime = _frameTimeMax;
 	_frames = 0;
+	_frameTime = 0;
+	_frameTimeMax = 0;
 	_redraw = true;
 }
 
+/**
+ * Returns the average time taken by each frame
+ * drawn during the last second.
+ * @return Time in milliseconds.
+ */
+Uint32 FpsCounter::getAverageFrameTime() const
+{
+	return _averageFrameTime;
+}
+
+/**
+ * Returns the longest time taken by a frame
+ * drawn during the last second.
+ * @return Time in milliseconds.
+ */
+Uint32 FpsCounter::getMaxFrameTime() const
+{
+	return _maxFrameTime;
+}
+
 /**
  * Draws the FPS counter.
  */
@@ -39,6 +39,7 @@ private:
 	NumberText *_text;
 	Timer *_timer;
 	int _frames;
+	Uint32 _frameTime, _frameTimeMax, _averageFrameTime, _maxFrameTime;
 public:
 	/// Creates a new FPS counter linked to a game.
 	FpsCounter(int width, int height, int x, int y);
@@ -50,8 +51,14 @@ public:
 	void setColor(Uint8 color);
 	/// Handles keyboard events.
 	void handle(Action *action);
-	/// Advances frame counter.
+	/// Advances the FPS timer.
 	void think();
+	/// Counts a drawn frame.
+	void addFrame(Uint32 time);
+	/// Gets the average frame time.
+	Uint32 getAverageFrameTime() const;
+	/// Gets the longest frame time.
+	Uint32 getMaxFrameTime() const;
 	// Updates FPS counter.
 	void update();
 	/// Draws the FPS counter.
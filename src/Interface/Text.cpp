@@ -19,6 +19,7 @@
 #include "Text.h"
 #include <sstream>
 #include "../Engine/Font.h"
+#include "../Engine/ShaderMove.h"
 
 namespace OpenXcom
 {
@@ -30,7 +31,7 @@ namespace OpenXcom
  * @param x X position in pixels.
  * @param y Y position in pixels.
  */
-Text::Text(int width, int height, int x, int y) : Surface(width, height, x, y), _big(0), _small(0), _font(0), _text(L""), _wrap(false), _invert(false), _contrast(false), _align(ALIGN_LEFT), _valign(ALIGN_TOP), _color(0), _color2(0)
+Text::Text(int width, int height, int x, int y) : Surface(width, height, x, y), _big(0), _small(0), _font(0), _text(L""), _glyphs(), _wrap(false), _invert(false), _contrast(false), _layout(false), _align(ALIGN_LEFT), _valign(ALIGN_TOP), _color(0), _color2(0)
 {
 }
 
@@ -183,6 +184,7 @@ void Text::setHighContrast(bool contrast)
 void Text::setAlign(TextHAlign align)
 {
 	_align = align;
+	_layout = false;
 	_redraw = true;
 }
 
@@ -194,6 +196,7 @@ void Text::setAlign(TextHAlign align)
 void Text::setVerticalAlign(TextVAlign valign)
 {
 	_valign = valign;
+	_layout = false;
 	_redraw = true;
 }
 
@@ -325,8 +328,9 @@ void Text::processText()
 		// Keep track of the width of the last line and word
 		else if (*c != 1)
 		{
-			width += font->getChar(*c)->getCrop()->w + font->getSpacing();
-			word += font->getChar(*c)->getCrop()->w + font->getSpacing();
+			int w = font->getCharSize(*c).w + font->getSpacing();
+			width += w;
+			word += w;
 
 			// Wordwrap if the last word doesn't fit the line
 			if (_wrap && width > getWidth())
@@ -339,16 +343,19 @@ void Text::processText()
 		}
 	}
 
+	_layout = false;
 	_redraw = true;
 }
 
 /**
- * Draws all the characters in the text with a really
- * nasty complex gritty text rendering algorithm logic stuff.
+ * Works out where each character of the text goes
+ * according to the alignment, so drawing the text
+ * is just a matter of blitting the glyphs.
  */
-void Text::draw()
+void Text::layoutText()
 {
-	Surface::draw();
+	_glyphs.clear();
+	_layout = true;
 	if (_text.empty() || _font == 0)
 	{
 		return;
@@ -356,7 +363,7 @@ void Text::draw()
 
 	int x = 0, y = 0, line = 0, height = 0;
 	Font *font = _font;
-	int color = _color;
+	bool secondary = false;
 	std::wstring *s = &_text;
 
 	for (std::vector<int>::iterator i = _lineHeight.begin(); i != _lineHeight.end(); ++i)
@@ -395,19 +402,7 @@ void Text::draw()
 		s = &_wrappedText;
 	}
 
-	// Set up text color
-	int mul = 1;
-	if (_contrast)
-	{
-		mul = 3;
-	}
-
-	// Invert text by inverting the font palette on index 3 (font palettes use indices 1-5)
-	int mid = _invert ? 3 : 0;
-
-	font->getSurface()->paletteShift(color, mul, mid);
-
-	// Draw each letter one by one
+	// Place each letter one by one
 	for (std::wstring::iterator c = s->begin(); c != s->end(); ++c)
 	{
 		if (*c == ' ')
@@ -432,29 +427,90 @@ void Text::draw()
 			}
 			if (*c == 2)
 			{
-				font->getSurface()->paletteRestore();
 				font = _small;
-				font->getSurface()->paletteShift(color, mul, mid);
 			}
 		}
 		else if (*c == 1)
 		{
-			font->getSurface()->paletteRestore();
-			color = (color == _color ? _color2 : _color);
-			font->getSurface()->paletteShift(color, mul, mid);
+			secondary = !secondary;
 		}
 		else
 		{
-			Surface* chr = font->getChar(*c);
-			chr->setX(x);
-			chr->setY(y);
-			chr->blit(this);
-			x += chr->getCrop()->w + font->getSpacing();
+			TextGlyph glyph;
+			glyph.font = font;
+			glyph.rect = font->getCharSize(*c);
+			glyph.x = x;
+			glyph.y = y;
+			glyph.secondary = secondary;
+			_glyphs.push_back(glyph);
+			x += glyph.rect.w + font->getSpacing();
+		}
+	}
+}
+
+/**
+ * Helper class used for Text::draw.
+ */
+struct TextColor
+{
+	/**
+	 * Function used by ShaderDraw in Text::draw.
+	 * Shifts the greyscale font pixels onto the text color,
+	 * same as shifting the font palette would.
+	 * @param dest Destination pixel.
+	 * @param src Source pixel.
+	 * @param color Base color of the text.
+	 * @param mul Color multiplier (for high contrast).
+	 * @param mid Middle color to invert around, 0 for none.
+	 */
+	static inline void func(Uint8& dest, const Uint8& src, const int& color, const int& mul, const int& mid)
+	{
+		if (src)
+		{
+			const int inverseOffset = mid ? 2 * (mid - src) : 0;
+			dest = (Uint8)(src * mul + color + inverseOffset);
 		}
 	}
+};
+
+/**
+ * Draws all the characters in the text, remapping
+ * the font colors while blitting each glyph.
+ */
+void Text::draw()
+{
+	Surface::draw();
+	if (_text.empty() || _font == 0)
+	{
+		return;
+	}
+
+	if (!_layout)
+	{
+		layoutText();
+	}
+
+	// Set up text color
+	int mul = 1;
+	if (_contrast)
+	{
+		mul = 3;
+	}
 
-	// Revert text color
-	font->getSurface()->paletteRestore();
+	// Invert text by inverting the font palette on index 3 (font palettes use indices 1-5)
+	int mid = _invert ? 3 : 0;
+
+	int color = _color, color2 = _color2;
+	ShaderMove<Uint8> dest(this, 0, 0);
+
+	lock();
+	for (std::vector<TextGlyph>::const_iterator i = _glyphs.begin(); i != _glyphs.end(); ++i)
+	{
+		ShaderMove<Uint8> src(i->font->getSurface(), i->x - i->rect.x, i->y - i->rect.y);
+		src.setDomain(GraphSubset(std::make_pair((int)i->rect.x, i->rect.x + i->rect.w), std::make_pair((int)i->rect.y, i->rect.y + i->rect.h)));
+		ShaderDraw<TextColor>(dest, src, ShaderScalar(i->secondary ? color2 : color), ShaderScalar(mul), ShaderScalar(mid));
+	}
+	unlock();
 }
 
 }
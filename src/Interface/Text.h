@@ -31,6 +31,18 @@ class Font;
 enum TextHAlign { ALIGN_LEFT, ALIGN_CENTER, ALIGN_RIGHT };
 enum TextVAlign { ALIGN_TOP, ALIGN_MIDDLE, ALIGN_BOTTOM };
 
+/**
+ * A single character laid out in a text,
+ * ready to be drawn from its font.
+ */
+struct TextGlyph
+{
+	Font *font;
+	SDL_Rect rect;
+	int x, y;
+	bool secondary;
+};
+
 /**
  * Text string displayed on screen.
  * Takes the characters from a Font and puts them together on screen
@@ -43,13 +55,16 @@ private:
 	Font *_big, *_small, *_font;
 	std::wstring _text, _wrappedText;
 	std::vector<int> _lineWidth, _lineHeight;
-	bool _wrap, _invert, _contrast;
+	std::vector<TextGlyph> _glyphs;
+	bool _wrap, _invert, _contrast, _layout;
 	TextHAlign _align;
 	TextVAlign _valign;
 	Uint8 _color, _color2;
 
 	/// Processes the contained text.
 	void processText();
+	/// Lays out the characters of the text.
+	void layoutText();
 public:
 	/// Creates a new text with the specified size and position.
 	Text(int width, int height, int x = 0, int y = 0);
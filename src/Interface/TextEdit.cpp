@@ -275,7 +275,7 @@ void TextEdit::draw()
 			}
 			else
 			{
-				x += _text->getFont()->getChar(_value[i])->getCrop()->w + _text->getFont()->getSpacing();
+				x += _text->getFont()->getCharSize(_value[i]).w + _text->getFont()->getSpacing();
 			}
 		}
 		_caret->setX(x);
@@ -305,7 +305,7 @@ bool TextEdit::exceedsMaxWidth(wchar_t c)
 		}
 		else
 		{
-			w += _text->getFont()->getChar(*i)->getCrop()->w + _text->getFont()->getSpacing();
+			w += _text->getFont()->getCharSize(*i).w + _text->getFont()->getSpacing();
 		}
 	}
 
@@ -19,6 +19,7 @@
 #include "TextList.h"
 #include <cstdarg>
 #include <cmath>
+#include <algorithm>
 #include "../Engine/Action.h"
 #include "../Engine/Font.h"
 #include "../Engine/Palette.h"
@@ -34,7 +35,7 @@ namespace OpenXcom
  * @param x X position in pixels.
  * @param y Y position in pixels.
  */
-TextList::TextList(int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _texts(), _columns(), _big(0), _small(0), _font(0), _scroll(0), _visibleRows(0), _color(0), _align(ALIGN_LEFT), _dot(false), _selectable(false), _condensed(false), _contrast(false),
+TextList::TextList(int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _rows(), _texts(), _slots(), _columns(), _big(0), _small(0), _font(0), _scroll(0), _visibleRows(0), _color(0), _align(ALIGN_LEFT), _dot(false), _selectable(false), _condensed(false), _contrast(false),
 																								   _selRow(0), _bg(0), _selector(0), _margin(0), _arrowLeft(), _arrowRight(), _arrowPos(-1), _arrowType(ARROW_VERTICAL), _leftClick(0), _leftPress(0), _leftRelease(0), _rightClick(0), _rightPress(0), _rightRelease(0)
 {
 	_up = new ArrowButton(ARROW_BIG_UP, 13, 14, getX() + getWidth() + 4, getY() + 1);
@@ -50,13 +51,7 @@ TextList::TextList(int width, int height, int x, int y) : InteractiveSurface(wid
  */
 TextList::~TextList()
 {
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
-	{
-		for (std::vector<Text*>::iterator v = (*u).begin(); v < (*u).end(); ++v)
-		{
-			delete *v;
-		}
-	}
+	clearSlots();
 	for (std::vector<ArrowButton*>::iterator i = _arrowLeft.begin(); i < _arrowLeft.end(); ++i)
 	{
 		delete *i;
@@ -88,14 +83,162 @@ void TextList::unpress(State *state)
 }
 
 /**
- * Changes the color of a specific Text object in the list.
+ * Returns the width a string would take up if it was
+ * displayed in the list, without needing a Text for it.
+ * @param text Text string.
+ * @return Width in pixels.
+ */
+int TextList::getStringWidth(const std::wstring &text) const
+{
+	int width = 0, line = 0;
+	for (std::wstring::const_iterator c = text.begin(); c != text.end(); ++c)
+	{
+		if (*c == L' ')
+		{
+			line += _font->getWidth() / 2;
+		}
+		else if (*c == L'\n' || *c == 2)
+		{
+			width = std::max(width, line);
+			line = 0;
+		}
+		else if (*c != 1)
+		{
+			line += _font->getCharSize(*c).w + _font->getSpacing();
+		}
+	}
+	return std::max(width, line);
+}
+
+/**
+ * Returns the Text used to display a certain column
+ * of a visible row, creating it if necessary.
+ * @param slot Visible row number.
+ * @param column Column number.
+ * @return Pointer to the Text.
+ */
+Text *TextList::getSlotText(unsigned int slot, unsigned int column)
+{
+	if (_texts.size() <= slot)
+	{
+		_texts.resize(slot + 1);
+		_slots.resize(slot + 1, -1);
+	}
+	std::vector<Text*> *texts = &_texts[slot];
+	while (texts->size() <= column)
+	{
+		Text *txt = new Text(_columns[texts->size()], _font->getHeight(), 0, 0);
+		txt->setPalette(getPalette());
+		txt->setFonts(_big, _small);
+		texts->push_back(txt);
+	}
+	return texts->at(column);
+}
+
+/**
+ * Sets up the Text of a visible row to show
+ * the contents of a certain cell.
+ * @param slot Visible row number.
+ * @param row Row number.
+ * @param column Column number.
+ */
+void TextList::bindCell(unsigned int slot, unsigned int row, unsigned int column)
+{
+	const TextListCell &cell = _rows[row][column];
+	Text *txt = getSlotText(slot, column);
+	txt->setX(cell.x);
+	txt->setColor(cell.color);
+	txt->setSecondaryColor(cell.color2);
+	txt->setAlign(cell.align);
+	txt->setHighContrast(cell.contrast);
+	if (cell.big)
+	{
+		txt->setBig();
+	}
+	else
+	{
+		txt->setSmall();
+	}
+	txt->setText(cell.text);
+}
+
+/**
+ * Returns which visible row is currently showing a certain row.
+ * @param row Row number.
+ * @return Visible row number, or -1 if the row isn't shown.
+ */
+int TextList::getRowSlot(unsigned int row) const
+{
+	if (row < _scroll || row - _scroll >= _slots.size() || _slots[row - _scroll] != (int)row)
+	{
+		return -1;
+	}
+	return row - _scroll;
+}
+
+/**
+ * Sets up the visible rows to show the rows currently scrolled
+ * into view. Rows that were already being shown are left alone.
+ */
+void TextList::updateSlots()
+{
+	if (_texts.size() < _visibleRows)
+	{
+		_texts.resize(_visibleRows);
+		_slots.resize(_visibleRows, -1);
+	}
+	for (unsigned int slot = 0; slot < _visibleRows; ++slot)
+	{
+		unsigned int row = _scroll + slot;
+		if (row >= _rows.size())
+		{
+			_slots[slot] = -1;
+			continue;
+		}
+		if (_slots[slot] == (int)row)
+		{
+			continue;
+		}
+		for (unsigned int col = 0; col < _rows[row].size(); ++col)
+		{
+			bindCell(slot, row, col);
+		}
+		_slots[slot] = row;
+	}
+}
+
+/**
+ * Deletes the Text's used by the visible rows,
+ * eg. when they need to change size.
+ */
+void TextList::clearSlots()
+{
+	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	{
+		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
+		{
+			delete *v;
+		}
+	}
+	_texts.clear();
+	_slots.clear();
+}
+
+/**
+ * Changes the color of a specific cell in the list.
  * @param row Row number.
  * @param column Column number.
  * @param color Text color.
  */
 void TextList::setCellColor(int row, int column, Uint8 color)
 {
-	_texts[row][column]->setColor(color);
+	_rows[row][column].color = color;
+	int slot = getRowSlot(row);
+	if (slot != -1)
+	{
+		getSlotText(slot, column)->setColor(color);
+	}
+	_redraw = true;
 }
 
 /**
@@ -105,39 +248,44 @@ void TextList::setCellColor(int row, int column, Uint8 color)
  */
 void TextList::setRowColor(int row, Uint8 color)
 {
-	for (std::vector<Text*>::iterator i = _texts[row].begin(); i < _texts[row].end(); ++i)
+	for (unsigned int col = 0; col < _rows[row].size(); ++col)
 	{
-		(*i)->setColor(color);
+		setCellColor(row, col, color);
 	}
-	_redraw = true;
 }
 
 /**
- * Returns the text of a specific Text object in the list.
+ * Returns the text of a specific cell in the list.
  * @param row Row number.
  * @param column Column number.
  * @return Text string.
  */
 std::wstring TextList::getCellText(int row, int column) const
 {
-	return _texts[row][column]->getText();
+	return _rows[row][column].text;
 }
 
 /**
- * Changes the text of a specific Text object in the list.
+ * Changes the text of a specific cell in the list.
+ * Only that cell is updated, the rest of the list stays as is.
  * @param row Row number.
  * @param column Column number.
  * @param text Text string.
  */
 void TextList::setCellText(int row, int column, const std::wstring &text)
 {
-	_texts[row][column]->setText(text);
+	_rows[row][column].text = text;
+	int slot = getRowSlot(row);
+	if (slot != -1)
+	{
+		getSlotText(slot, column)->setText(text);
+	}
 	_redraw = true;
 }
 
 /**
- * Adds a new row of text to the list, automatically creating
- * the required Text objects lined up where they need to be.
+ * Adds a new row of text to the list. Only the contents are
+ * stored, the Text's are only set up once the row is visible.
  * @param cols Number of columns.
  * @param ... Text for each cell in the new row.
  */
@@ -145,56 +293,46 @@ void TextList::addRow(int cols, ...)
 {
 	va_list args;
 	va_start(args, cols);
-	std::vector<Text*> temp;
+	std::vector<TextListCell> temp;
 	int rowX = 0;
 
 	for (int i = 0; i < cols; ++i)
 	{
-		// Place text
-		Text* txt = new Text(_columns[i], _font->getHeight(), _margin + rowX, getY());
-		txt->setPalette(this->getPalette());
-		txt->setFonts(_big, _small);
-		txt->setColor(_color);
-		txt->setSecondaryColor(_color2);
-		txt->setAlign(_align);
-		txt->setHighContrast(_contrast);
-		if (_font == _big)
-		{
-			txt->setBig();
-		}
-		else
-		{
-			txt->setSmall();
-		}
-		txt->setText(va_arg(args, wchar_t*));
+		TextListCell cell;
+		cell.text = va_arg(args, wchar_t*);
+		cell.x = _margin + rowX;
+		cell.color = _color;
+		cell.color2 = _color2;
+		cell.align = _align;
+		cell.big = (_font == _big);
+		cell.contrast = _contrast;
+
+		int w = getStringWidth(cell.text);
 
 		// Places dots between text
 		if (_dot && i < cols - 1)
 		{
-			std::wstring buf = txt->getText();
-			int w = txt->getTextWidth();
 			while (w < _columns[i])
 			{
-				w += _font->getChar('.')->getCrop()->w + _font->getSpacing();
-				buf += '.';
+				w += _font->getCharSize(L'.').w + _font->getSpacing();
+				cell.text += '.';
 			}
-			txt->setText(buf);
 		}
 
-		temp.push_back(txt);
+		temp.push_back(cell);
 		if (_condensed)
 		{
-			rowX += txt->getTextWidth();
+			rowX += w;
 		}
 		else
 		{
 			rowX += _columns[i];
 		}
 	}
-	_texts.push_back(temp);
+	_rows.push_back(temp);
 
-	// Place arrow buttons
-	if (_arrowPos != -1)
+	// Place arrow buttons for the visible rows
+	if (_arrowPos != -1 && _arrowLeft.size() < _rows.size() && _arrowLeft.size() < _visibleRows)
 	{
 		ArrowShape shape1, shape2;
 		if (_arrowType == ARROW_VERTICAL)
@@ -291,17 +429,32 @@ void TextList::setFonts(Font *big, Font *small)
 {
 	_big = big;
 	_small = small;
-	_font = small;
+	changeFont(small);
+}
+
+/**
+ * Changes the font used by the list, recalculating the
+ * selector and visible amount of rows to match.
+ * @param font Pointer to new font.
+ */
+void TextList::changeFont(Font *font)
+{
+	_font = font;
 
 	delete _selector;
 	_selector = new Surface(getWidth(), _font->getHeight() + _font->getSpacing(), getX(), getY());
 	_selector->setPalette(getPalette());
 	_selector->setVisible(false);
 
+	_visibleRows = 0;
 	for (int y = 0; y < getHeight(); y += _font->getHeight() + _font->getSpacing())
 	{
 		_visibleRows++;
 	}
+
+	// The row heights changed
+	clearSlots();
+	_redraw = true;
 }
 
 /**
@@ -388,17 +541,7 @@ void TextList::setSelectable(bool selectable)
  */
 void TextList::setBig()
 {
-	_font = _big;
-
-	delete _selector;
-	_selector = new Surface(getWidth(), _font->getHeight() + _font->getSpacing(), getX(), getY());
-	_selector->setPalette(getPalette());
-	_selector->setVisible(false);
-
-	for (int y = 0; y < getHeight(); y += _font->getHeight() + _font->getSpacing())
-	{
-		_visibleRows++;
-	}
+	changeFont(_big);
 }
 
 /**
@@ -406,17 +549,7 @@ void TextList::setBig()
  */
 void TextList::setSmall()
 {
-	_font = _small;
-
-	delete _selector;
-	_selector = new Surface(getWidth(), _font->getHeight() + _font->getSpacing(), getX(), getY());
-	_selector->setPalette(getPalette());
-	_selector->setVisible(false);
-
-	for (int y = 0; y < getHeight(); y += _font->getHeight() + _font->getSpacing())
-	{
-		_visibleRows++;
-	}
+	changeFont(_small);
 }
 
 /**
@@ -571,15 +704,9 @@ void TextList::onRightArrowRelease(ActionHandler handler)
  */
 void TextList::clearList()
 {
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
-	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
-		{
-			delete (*v);
-		}
-		u->clear();
-	}
-	_texts.clear();
+	_rows.clear();
+	_slots.assign(_slots.size(), -1);
+	_redraw = true;
 }
 
 /**
@@ -587,7 +714,7 @@ void TextList::clearList()
  */
 void TextList::scrollUp()
 {
-	if (_texts.size() > _visibleRows && _scroll > 0)
+	if (_rows.size() > _visibleRows && _scroll > 0)
 	{
 		_scroll--;
 		_redraw = true;
@@ -600,7 +727,7 @@ void TextList::scrollUp()
  */
 void TextList::scrollDown()
 {
-	if (_texts.size() > _visibleRows && _scroll < _texts.size() - _visibleRows)
+	if (_rows.size() > _visibleRows && _scroll < _rows.size() - _visibleRows)
 	{
 		_scroll++;
 		_redraw = true;
@@ -614,8 +741,8 @@ void TextList::scrollDown()
  */
 void TextList::updateArrows()
 {
-	_up->setVisible((_texts.size() > _visibleRows && _scroll > 0));
-	_down->setVisible((_texts.size() > _visibleRows && _scroll < _texts.size() - _visibleRows));
+	_up->setVisible((_rows.size() > _visibleRows && _scroll > 0));
+	_down->setVisible((_rows.size() > _visibleRows && _scroll < _rows.size() - _visibleRows));
 }
 
 /**
@@ -624,12 +751,14 @@ void TextList::updateArrows()
 void TextList::draw()
 {
 	Surface::draw();
-	for (unsigned int i = _scroll; i < _texts.size() && i < _scroll + _visibleRows; ++i)
+	updateSlots();
+	for (unsigned int i = _scroll; i < _rows.size() && i < _scroll + _visibleRows; ++i)
 	{
-		for (std::vector<Text*>::iterator j = _texts[i].begin(); j < _texts[i].end(); ++j)
+		std::vector<Text*> *texts = &_texts[i - _scroll];
+		for (unsigned int j = 0; j < _rows[i].size(); ++j)
 		{
-			(*j)->setY((i - _scroll) * (_font->getHeight() + _font->getSpacing()));
-			(*j)->blit(this);
+			(*texts)[j]->setY((i - _scroll) * (_font->getHeight() + _font->getSpacing()));
+			(*texts)[j]->blit(this);
 		}
 	}
 }
@@ -651,11 +780,11 @@ void TextList::blit(Surface *surface)
 		_down->blit(surface);
 		if (_arrowPos != -1)
 		{
-			for (unsigned int i = _scroll; i < _texts.size() && i < _scroll + _visibleRows; ++i)
+			for (unsigned int i = 0; i < _arrowLeft.size() && _scroll + i < _rows.size(); ++i)
 			{
-				_arrowLeft[i]->setY(getY() + (i - _scroll) * (_font->getHeight() + _font->getSpacing()));
+				_arrowLeft[i]->setY(getY() + i * (_font->getHeight() + _font->getSpacing()));
 				_arrowLeft[i]->blit(surface);
-				_arrowRight[i]->setY(getY() + (i - _scroll) * (_font->getHeight() + _font->getSpacing()));
+				_arrowRight[i]->setY(getY() + i * (_font->getHeight() + _font->getSpacing()));
 				_arrowRight[i]->blit(surface);
 			}
 		}
@@ -674,7 +803,7 @@ void TextList::handle(Action *action, State *state)
 	_down->handle(action, state);
 	if (_arrowPos != -1)
 	{
-		for (unsigned int i = _scroll; i < _texts.size() && i < _scroll + _visibleRows; ++i)
+		for (unsigned int i = 0; i < _arrowLeft.size() && _scroll + i < _rows.size(); ++i)
 		{
 			_arrowLeft[i]->handle(action, state);
 			_arrowRight[i]->handle(action, state);
@@ -709,7 +838,7 @@ void TextList::mousePress(Action *action, State *state)
 {
 	if (_selectable && action->getDetails()->button.button == SDL_BUTTON_LEFT)
 	{
-		if (_selRow < _texts.size())
+		if (_selRow < _rows.size())
 		{
 			InteractiveSurface::mousePress(action, state);
 		}
@@ -733,7 +862,7 @@ void TextList::mouseRelease(Action *action, State *state)
 {
 	if (_selectable && action->getDetails()->button.button == SDL_BUTTON_LEFT)
 	{
-		if (_selRow < _texts.size())
+		if (_selRow < _rows.size())
 		{
 			InteractiveSurface::mouseRelease(action, state);
 		}
@@ -749,7 +878,7 @@ void TextList::mouseClick(Action *action, State *state)
 {
 	if (_selectable && action->getDetails()->button.button == SDL_BUTTON_LEFT)
 	{
-		if (_selRow < _texts.size())
+		if (_selRow < _rows.size())
 		{
 			InteractiveSurface::mouseClick(action, state);
 		}
@@ -768,7 +897,7 @@ void TextList::mouseOver(Action *action, State *state)
 		int h = _font->getHeight() + _font->getSpacing();
 		_selRow = _scroll + (int)floor(action->getRelativeYMouse() / (h * action->getYScale()));
 
-		if (_selRow < _texts.size())
+		if (_selRow < _rows.size())
 		{
 			_selector->setY(getY() + (_selRow - _scroll) * h);
 			_selector->copy(_bg);
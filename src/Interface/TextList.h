@@ -31,16 +31,33 @@ enum ArrowOrientation { ARROW_VERTICAL, ARROW_HORIZONTAL };
 class Font;
 class ArrowButton;
 
+/**
+ * Contents of a single cell in a text list,
+ * kept separate from the Text used to display it.
+ */
+struct TextListCell
+{
+	std::wstring text;
+	int x;
+	Uint8 color, color2;
+	TextHAlign align;
+	bool big, contrast;
+};
+
 /**
  * List of Text's split into columns.
  * Contains a set of Text's that are automatically lined up by
  * rows and columns, like a big table, making it easy to manage
  * them together.
+ * Only the visible rows have Text's, which get reused
+ * for other rows as the list is scrolled.
  */
 class TextList : public InteractiveSurface
 {
 private:
+	std::vector< std::vector<TextListCell> > _rows;
 	std::vector< std::vector<Text*> > _texts;
+	std::vector<int> _slots;
 	std::vector<int> _columns;
 	Font *_big, *_small, *_font;
 	unsigned int _scroll, _visibleRows;
@@ -58,6 +75,20 @@ private:
 
 	/// Updates the arrow buttons.
 	void updateArrows();
+	/// Gets the width of a string in the list font.
+	int getStringWidth(const std::wstring &text) const;
+	/// Gets the Text showing a cell in a visible row.
+	Text *getSlotText(unsigned int slot, unsigned int column);
+	/// Shows a cell in a visible row.
+	void bindCell(unsigned int slot, unsigned int row, unsigned int column);
+	/// Gets the visible row showing a row.
+	int getRowSlot(unsigned int row) const;
+	/// Shows the rows currently scrolled into view.
+	void updateSlots();
+	/// Removes the Text's of the visible rows.
+	void clearSlots();
+	/// Changes the font of the list.
+	void changeFont(Font *font);
 public:
 	/// Creates a text list with the specified size and position.
 	TextList(int width, int height, int x = 0, int y = 0);
@@ -134,7 +134,7 @@ void Window::popup()
 {
 	if (_popupStep == 0.0)
 	{
-		int sound = RNG::generate(0, 2);
+		int sound = RNG::generate(RNG::STREAM_COSMETIC, 0, 2);
 		if (soundPopup[sound] != 0)
 		{
 			soundPopup[sound]->play();
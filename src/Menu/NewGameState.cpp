@@ -18,6 +18,7 @@
  */
 #include "NewGameState.h"
 #include "../Engine/Game.h"
+#include "../Engine/RNG.h"
 #include "../Resource/ResourcePack.h"
 #include "../Engine/Language.h"
 #include "../Engine/Font.h"
@@ -99,6 +100,7 @@ NewGameState::~NewGameState()
  */
 void NewGameState::newGame(GameDifficulty diff)
 {
+	RNG::init();
 	_game->setRuleset(new XcomRuleset());
 	_game->setSavedGame(_game->getRuleset()->newSave(diff));
 	GeoscapeState *gs = new GeoscapeState(_game);
@@ -19,6 +19,7 @@
 #include "StartState.h"
 #include <SDL.h>
 #include "../Engine/Game.h"
+#include "../Engine/FrameScheduler.h"
 #include "../Engine/Action.h"
 #include "../Resource/XcomResourcePack.h"
 #include "../Engine/Surface.h"
@@ -77,6 +78,7 @@ void StartState::think()
 	switch (_load)
 	{
 	case LOADING_STARTED:
+		_game->getFrameScheduler()->setBusy();
 		try
 		{
 			_game->setResourcePack(new XcomResourcePack());
@@ -97,6 +99,7 @@ void StartState::think()
 		break;
 	case LOADING_NONE:
 		_load = LOADING_STARTED;
+		_game->getFrameScheduler()->setBusy();
 		break;
 	case LOADING_SUCCESSFUL:
 		if (Options::getString("language") == "" || Options::getString("language") == "~")
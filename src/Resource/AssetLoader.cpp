@@ -0,0 +1,184 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "AssetLoader.h"
+#include "../Engine/Surface.h"
+#include "../Engine/SurfaceSet.h"
+#include "../Engine/Exception.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a loader with no assets queued.
+ */
+AssetLoader::AssetLoader() : _assets(), _next(0), _error("")
+{
+	_mutex = SDL_CreateMutex();
+}
+
+/**
+ *
+ */
+AssetLoader::~AssetLoader()
+{
+	SDL_DestroyMutex(_mutex);
+}
+
+/**
+ * Queues a SCR image to be loaded into a surface.
+ * @param surface Pointer to the surface to load into.
+ * @param file Filename of the SCR image.
+ */
+void AssetLoader::addScr(Surface *surface, const std::string &file)
+{
+	Asset asset = {ASSET_SCR, surface, 0, file, ""};
+	_assets.push_back(asset);
+}
+
+/**
+ * Queues a SPK image to be loaded into a surface.
+ * @param surface Pointer to the surface to load into.
+ * @param file Filename of the SPK image.
+ */
+void AssetLoader::addSpk(Surface *surface, const std::string &file)
+{
+	Asset asset = {ASSET_SPK, surface, 0, file, ""};
+	_assets.push_back(asset);
+}
+
+/**
+ * Queues a PCK/TAB image set to be loaded into a surface set.
+ * @param set Pointer to the surface set to load into.
+ * @param pck Filename of the PCK image.
+ * @param tab Filename of the TAB offsets.
+ */
+void AssetLoader::addPck(SurfaceSet *set, const std::string &pck, const std::string &tab)
+{
+	Asset asset = {ASSET_PCK, 0, set, pck, tab};
+	_assets.push_back(asset);
+}
+
+/**
+ * Queues a DAT image set to be loaded into a surface set.
+ * @param set Pointer to the surface set to load into.
+ * @param file Filename of the DAT image.
+ */
+void AssetLoader::addDat(SurfaceSet *set, const std::string &file)
+{
+	Asset asset = {ASSET_DAT, 0, set, file, ""};
+	_assets.push_back(asset);
+}
+
+/**
+ * Decodes a single asset into its surface. Each asset
+ * only touches its own surface, so they can be run
+ * from any thread.
+ * @param asset Asset to load.
+ */
+void AssetLoader::load(const Asset &asset)
+{
+	switch (asset.type)
+	{
+	case ASSET_SCR:
+		asset.surface->loadScr(asset.file);
+		break;
+	case ASSET_SPK:
+		asset.surface->loadSpk(asset.file);
+		break;
+	case ASSET_PCK:
+		asset.set->loadPck(asset.file, asset.tab);
+		break;
+	case ASSET_DAT:
+		asset.set->loadDat(asset.file);
+		break;
+	}
+}
+
+/**
+ * Worker loop: keeps taking the next queued asset and
+ * loading it until the queue is empty or something failed.
+ * @param loader Pointer to the asset loader.
+ * @return Always 0.
+ */
+int AssetLoader::work(void *loader)
+{
+	AssetLoader *self = (AssetLoader*)loader;
+	while (true)
+	{
+		SDL_LockMutex(self->_mutex);
+		if (self->_next >= self->_assets.size() || !self->_error.empty())
+		{
+			SDL_UnlockMutex(self->_mutex);
+			break;
+		}
+		size_t i = self->_next++;
+		SDL_UnlockMutex(self->_mutex);
+
+		try
+		{
+			self->load(self->_assets[i]);
+		}
+		catch (Exception &e)
+		{
+			SDL_LockMutex(self->_mutex);
+			if (self->_error.empty())
+			{
+				self->_error = e.what();
+			}
+			SDL_UnlockMutex(self->_mutex);
+		}
+	}
+	return 0;
+}
+
+/**
+ * Loads all the queued assets, using the calling thread
+ * plus extra worker threads if more than one is requested.
+ * Any loading error is rethrown once all threads are done.
+ * @param threads Number of threads to load with.
+ */
+void AssetLoader::run(int threads)
+{
+	std::vector<SDL_Thread*> workers;
+	for (int i = 1; i < threads && (size_t)i < _assets.size(); ++i)
+	{
+		SDL_Thread *thread = SDL_CreateThread(work, this);
+		if (thread == 0)
+		{
+			break;
+		}
+		workers.push_back(thread);
+	}
+	work(this);
+	for (std::vector<SDL_Thread*>::iterator i = workers.begin(); i != workers.end(); ++i)
+	{
+		SDL_WaitThread(*i, 0);
+	}
+
+	_assets.clear();
+	_next = 0;
+	if (!_error.empty())
+	{
+		std::string error = _error;
+		_error = "";
+		throw Exception(error);
+	}
+}
+
+}
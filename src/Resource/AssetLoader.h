@@ -0,0 +1,76 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_ASSETLOADER_H
+#define OPENXCOM_ASSETLOADER_H
+
+#include <string>
+#include <vector>
+#include <SDL.h>
+
+namespace OpenXcom
+{
+
+class Surface;
+class SurfaceSet;
+
+/**
+ * Queues up image files to be decoded into their surfaces
+ * and loads them all at once, spreading the independent
+ * files across a pool of worker threads.
+ */
+class AssetLoader
+{
+private:
+	enum AssetType { ASSET_SCR, ASSET_SPK, ASSET_PCK, ASSET_DAT };
+	struct Asset
+	{
+		AssetType type;
+		Surface *surface;
+		SurfaceSet *set;
+		std::string file, tab;
+	};
+	std::vector<Asset> _assets;
+	size_t _next;
+	SDL_mutex *_mutex;
+	std::string _error;
+
+	/// Loads queued assets until there's none left.
+	static int work(void *loader);
+	/// Loads a single asset.
+	void load(const Asset &asset);
+public:
+	/// Creates an empty asset loader.
+	AssetLoader();
+	/// Cleans up the asset loader.
+	~AssetLoader();
+	/// Queues a SCR image.
+	void addScr(Surface *surface, const std::string &file);
+	/// Queues a SPK image.
+	void addSpk(Surface *surface, const std::string &file);
+	/// Queues a PCK/TAB set.
+	void addPck(SurfaceSet *set, const std::string &pck, const std::string &tab);
+	/// Queues a DAT set.
+	void addDat(SurfaceSet *set, const std::string &file);
+	/// Loads all the queued assets.
+	void run(int threads);
+};
+
+}
+
+#endif
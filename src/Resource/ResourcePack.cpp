@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "ResourcePack.h"
+#include <algorithm>
 #include "../Engine/Palette.h"
 #include "../Engine/Font.h"
 #include "../Engine/Surface.h"
@@ -33,7 +34,7 @@ namespace OpenXcom
 /**
  * Initializes a blank resource set pointing to a folder.
  */
-ResourcePack::ResourcePack() : _palettes(), _fonts(), _surfaces(), _sets(), _polygons(), _musics()
+ResourcePack::ResourcePack() : _lazySurfaces(), _lazySets(), _recentSurfaces(), _hasColors(false), _palettes(), _fonts(), _surfaces(), _sets(), _polygons(), _musics(), _maxRecentSurfaces(8)
 {
 }
 
@@ -88,22 +89,130 @@ Font *const ResourcePack::getFont(const std::string &name) const
 
 /**
  * Returns a specific surface from the resource set.
+ * Lazy surfaces are decoded the first time they're asked for,
+ * and evictable ones are kept in a most-recently-used list
+ * so only a limited amount of them stay in memory. The
+ * returned pointer must not be kept around for those.
  * @param name Name of the surface.
  * @return Pointer to the surface.
  */
 Surface *const ResourcePack::getSurface(const std::string &name) const
 {
-	return _surfaces.find(name)->second;
+	std::map<std::string, LazyImage>::const_iterator lazy = _lazySurfaces.find(name);
+	if (lazy == _lazySurfaces.end())
+	{
+		return _surfaces.find(name)->second;
+	}
+
+	std::map<std::string, Surface*>::iterator i = _surfaces.find(name);
+	if (i == _surfaces.end())
+	{
+		const LazyImage &image = lazy->second;
+		Surface *surface = new Surface(image.width, image.height);
+		std::string ext = image.file.substr(image.file.length() - 3);
+		try
+		{
+			if (ext == "SPK" || ext == "spk")
+			{
+				surface->loadSpk(image.file);
+			}
+			else
+			{
+				surface->loadScr(image.file);
+			}
+		}
+		catch (...)
+		{
+			delete surface;
+			throw;
+		}
+		if (_hasColors)
+		{
+			surface->setPalette(const_cast<SDL_Color*>(_colors));
+		}
+		i = _surfaces.insert(std::make_pair(name, surface)).first;
+	}
+
+	if (lazy->second.evictable)
+	{
+		std::list<std::string>::iterator recent = std::find(_recentSurfaces.begin(), _recentSurfaces.end(), name);
+		if (recent != _recentSurfaces.end())
+		{
+			_recentSurfaces.erase(recent);
+		}
+		_recentSurfaces.push_front(name);
+		while (_recentSurfaces.size() > _maxRecentSurfaces)
+		{
+			std::map<std::string, Surface*>::iterator old = _surfaces.find(_recentSurfaces.back());
+			delete old->second;
+			_surfaces.erase(old);
+			_recentSurfaces.pop_back();
+		}
+	}
+	return i->second;
 }
 
 /**
  * Returns a specific surface set from the resource set.
+ * Lazy surface sets are decoded the first time they're asked for.
  * @param name Name of the surface set.
  * @return Pointer to the surface set.
  */
 SurfaceSet *const ResourcePack::getSurfaceSet(const std::string &name) const
 {
-	return _sets.find(name)->second;
+	std::map<std::string, SurfaceSet*>::iterator i = _sets.find(name);
+	if (i == _sets.end())
+	{
+		std::map<std::string, LazyImage>::const_iterator lazy = _lazySets.find(name);
+		if (lazy != _lazySets.end())
+		{
+			const LazyImage &image = lazy->second;
+			SurfaceSet *set = new SurfaceSet(image.width, image.height);
+			std::string ext = image.file.substr(image.file.length() - 3);
+			if (ext == "PCK" || ext == "pck")
+			{
+				set->loadPck(image.file, image.tab);
+			}
+			else
+			{
+				set->loadDat(image.file);
+			}
+			if (_hasColors)
+			{
+				set->setPalette(const_cast<SDL_Color*>(_colors));
+			}
+			i = _sets.insert(std::make_pair(name, set)).first;
+		}
+	}
+	return i->second;
+}
+
+/**
+ * Registers a surface that's only loaded once it's needed.
+ * @param name Name of the surface.
+ * @param file Filename of the SCR/SPK image.
+ * @param width Surface width.
+ * @param height Surface height.
+ * @param evictable Can be unloaded when not recently used.
+ */
+void ResourcePack::addLazySurface(const std::string &name, const std::string &file, int width, int height, bool evictable)
+{
+	LazyImage image = {file, "", width, height, evictable};
+	_lazySurfaces[name] = image;
+}
+
+/**
+ * Registers a surface set that's only loaded once it's needed.
+ * @param name Name of the surface set.
+ * @param pck Filename of the PCK/DAT image.
+ * @param tab Filename of the TAB offsets, if it's a PCK image.
+ * @param width Frame width.
+ * @param height Frame height.
+ */
+void ResourcePack::addLazySurfaceSet(const std::string &name, const std::string &pck, const std::string &tab, int width, int height)
+{
+	LazyImage image = {pck, tab, width, height, false};
+	_lazySets[name] = image;
 }
 
 /**
@@ -162,6 +271,8 @@ Palette *const ResourcePack::getPalette(const std::string &name) const
  */
 void ResourcePack::setPalette(SDL_Color *colors, int firstcolor, int ncolors)
 {
+	std::copy(colors, colors + ncolors, _colors + firstcolor);
+	_hasColors = true;
 	for (std::map<std::string, Font*>::iterator i = _fonts.begin(); i != _fonts.end(); ++i)
 	{
 		i->second->getSurface()->setPalette(colors, firstcolor, ncolors);
@@ -51,16 +51,34 @@ class MapBlock;
  */
 class ResourcePack
 {
+private:
+	/// Image file that's only decoded the first time it's used.
+	struct LazyImage
+	{
+		std::string file, tab;
+		int width, height;
+		bool evictable;
+	};
+	std::map<std::string, LazyImage> _lazySurfaces, _lazySets;
+	mutable std::list<std::string> _recentSurfaces;
+	SDL_Color _colors[256];
+	bool _hasColors;
 protected:
 	std::map<std::string, Palette*> _palettes;
 	std::map<std::string, Font*> _fonts;
-	std::map<std::string, Surface*> _surfaces;
-	std::map<std::string, SurfaceSet*> _sets;
+	mutable std::map<std::string, Surface*> _surfaces;
+	mutable std::map<std::string, SurfaceSet*> _sets;
 	std::map<std::string, SoundSet*> _sounds;
 	std::list<Polygon*> _polygons;
 	std::list<Polyline*> _polylines;
 	std::map<std::string, Music*> _musics;
 	std::vector<Uint16> _voxelData;
+	size_t _maxRecentSurfaces;
+
+	/// Adds a surface to be loaded on first use.
+	void addLazySurface(const std::string &name, const std::string &file, int width, int height, bool evictable);
+	/// Adds a surface set to be loaded on first use.
+	void addLazySurfaceSet(const std::string &name, const std::string &pck, const std::string &tab, int width, int height);
 public:
 	/// Create a new resource pack with a folder's contents.
 	ResourcePack();
@@ -18,6 +18,7 @@
  */
 #include "XcomResourcePack.h"
 #include <sstream>
+#include <algorithm>
 #include "../Engine/CrossPlatform.h"
 #include "../Engine/Palette.h"
 #include "../Engine/Font.h"
@@ -26,6 +27,7 @@
 #include "../Engine/Language.h"
 #include "../Engine/Music.h"
 #include "../Engine/GMCat.h"
+#include "../Engine/AssetCache.h"
 #include "../Engine/SoundSet.h"
 #include "../Engine/Options.h"
 #include "../Geoscape/Globe.h"
@@ -39,6 +41,7 @@
 #include "../Savegame/NodeLink.h"
 #include "../Battlescape/Position.h"
 #include "../Ruleset/MapDataSet.h"
+#include "AssetLoader.h"
 
 namespace OpenXcom
 {
@@ -49,6 +52,11 @@ namespace OpenXcom
  */
 XcomResourcePack::XcomResourcePack() : ResourcePack()
 {
+	if (Options::getBool("assetCache"))
+	{
+		AssetCache::init(Options::getUserFolder() + "cache");
+	}
+
 	// Load palettes
 	for (int i = 0; i < 5; ++i)
 	{
@@ -65,6 +73,9 @@ XcomResourcePack::XcomResourcePack() : ResourcePack()
 	_palettes[s2.str()] = new Palette();
 	_palettes[s2.str()]->loadDat(CrossPlatform::getDataFile(s1.str()), 128);
 
+	// Images are queued up and decoded together on the loader threads
+	AssetLoader loader;
+
 	// Load fonts
 	Font::loadIndex(CrossPlatform::getDataFile("Language/Font.dat"));
 
@@ -79,8 +90,7 @@ XcomResourcePack::XcomResourcePack() : ResourcePack()
 			_fonts[font[i]] = new Font(16, 16, 0);
 		else if (font[i] == "Small.fnt")
 			_fonts[font[i]] = new Font(8, 9, -1);
-		_fonts[font[i]]->getSurface()->loadScr(CrossPlatform::getDataFile(s.str()));
-		_fonts[font[i]]->load();
+		loader.addScr(_fonts[font[i]]->getSurface(), CrossPlatform::getDataFile(s.str()));
 	}
 
 	// Load surfaces
@@ -88,7 +98,7 @@ XcomResourcePack::XcomResourcePack() : ResourcePack()
 		std::stringstream s;
 		s << "GEODATA/" << "INTERWIN.DAT";
 		_surfaces["INTERWIN.DAT"] = new Surface(160, 556);
-		_surfaces["INTERWIN.DAT"]->loadScr(CrossPlatform::getDataFile(s.str()));
+		loader.addScr(_surfaces["INTERWIN.DAT"], CrossPlatform::getDataFile(s.str()));
 	}
 
 	std::string scrs[] = {"BACK01.SCR",
@@ -111,12 +121,13 @@ XcomResourcePack::XcomResourcePack() : ResourcePack()
 						  "GEOBORD.SCR",
 						  "UP_BORD2.SCR"};
 
+	// Backgrounds are only loaded once they're shown, and kept
+	// since windows hang on to them
 	for (int i = 0; i < 19; ++i)
 	{
 		std::stringstream s;
 		s << "GEOGRAPH/" << scrs[i];
-		_surfaces[scrs[i]] = new Surface(320, 200);
-		_surfaces[scrs[i]]->loadScr(CrossPlatform::getDataFile(s.str()));
+		addLazySurface(scrs[i], CrossPlatform::getDataFile(s.str()), 320, 200, false);
 	}
 
 	std::string spks[] = {"UP001.SPK",
@@ -163,15 +174,18 @@ XcomResourcePack::XcomResourcePack() : ResourcePack()
 						  "UP042.SPK",
 						  "GRAPHS.SPK"};
 
+	// UFOpaedia images are only blitted when an article is opened,
+	// so only the most recently viewed ones are kept in memory
+	// (at least the one being looked at, or it would be freed before it's used)
+	_maxRecentSurfaces = std::max(1, Options::getInt("maxCachedImages"));
 	for (int i = 0; i < 43; ++i)
 	{
 		std::stringstream s;
 		s << "GEOGRAPH/" << spks[i];
-		_surfaces[spks[i]] = new Surface(320, 200);
-		_surfaces[spks[i]]->loadSpk(CrossPlatform::getDataFile(s.str()));
+		addLazySurface(spks[i], CrossPlatform::getDataFile(s.str()), 320, 200, true);
 	}
 
-	// Load surface sets
+	// Load surface sets (on first use)
 	std::string sets[] = {"BASEBITS.PCK",
 						  "INTICON.PCK",
 						  "TEXTURE.DAT"};
@@ -187,19 +201,17 @@ XcomResourcePack::XcomResourcePack() : ResourcePack()
 			std::string tab = sets[i].substr(0, sets[i].length()-4) + ".TAB";
 			std::stringstream s2;
 			s2 << "GEOGRAPH/" << tab;
-			_sets[sets[i]] = new SurfaceSet(32, 40);
-			_sets[sets[i]]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+			addLazySurfaceSet(sets[i], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()), 32, 40);
 		}
 		else
 		{
-			_sets[sets[i]] = new SurfaceSet(32, 32);
-			_sets[sets[i]]->loadDat(CrossPlatform::getDataFile(s.str()));
+			addLazySurfaceSet(sets[i], CrossPlatform::getDataFile(s.str()), "", 32, 32);
 		}
 	}
 	_sets["SCANG.DAT"] = new SurfaceSet(4, 4);
 	std::stringstream scang;
 	scang << "GEODATA/" << "SCANG.DAT";
-	_sets["SCANG.DAT"]->loadDat (CrossPlatform::getDataFile(scang.str()));
+	loader.addDat(_sets["SCANG.DAT"], CrossPlatform::getDataFile(scang.str()));
 	// Load polygons
 	std::stringstream s;
 	s << "GEODATA/" << "WORLD.DAT";
@@ -271,6 +283,12 @@ XcomResourcePack::XcomResourcePack() : ResourcePack()
 	}
 	_polylines.push_back(l);
 
+	loader.run(Options::getInt("loaderThreads"));
+	for (std::map<std::string, Font*>::iterator i = _fonts.begin(); i != _fonts.end(); ++i)
+	{
+		i->second->load();
+	}
+
 	if (!Options::getBool("mute"))
 	{
 		// Load musics
@@ -310,7 +328,23 @@ XcomResourcePack::XcomResourcePack() : ResourcePack()
 		{
 			if (cat)
 			{
-				_musics[mus[i]] = gmcat->loadMIDI(tracks[i]);
+				// Converted MIDI is cached since the conversion is slow
+				std::string path = CrossPlatform::getDataFile(musDos);
+				std::stringstream key;
+				key << path << "#" << tracks[i];
+				std::vector<unsigned char> midi;
+				if (!AssetCache::load(key.str(), path, &midi))
+				{
+					if (gmcat->convertMIDI(tracks[i], &midi))
+					{
+						AssetCache::save(key.str(), path, midi);
+					}
+				}
+				_musics[mus[i]] = new Music();
+				if (!midi.empty())
+				{
+					_musics[mus[i]]->load(&midi[0], midi.size());
+				}
 			}
 			else
 			{
@@ -392,42 +426,44 @@ XcomResourcePack::~XcomResourcePack()
 
 void XcomResourcePack::loadBattlescapeResources()
 {
+	AssetLoader loader;
+
 	// Load Battlescape ICONS
 	std::stringstream s;
 	s << "UFOGRAPH/" << "SPICONS.DAT";
 	_sets["SPICONS.DAT"] = new SurfaceSet(32, 24);
-	_sets["SPICONS.DAT"]->loadDat(CrossPlatform::getDataFile(s.str()));
+	loader.addDat(_sets["SPICONS.DAT"], CrossPlatform::getDataFile(s.str()));
 
 	s.str("");
 	std::stringstream s2;
 	s << "UFOGRAPH/" << "CURSOR.PCK";
 	s2 << "UFOGRAPH/" << "CURSOR.TAB";
 	_sets["CURSOR.PCK"] = new SurfaceSet(32, 40);
-	_sets["CURSOR.PCK"]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+	loader.addPck(_sets["CURSOR.PCK"], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
 
 	s.str("");
 	s2.str("");
 	s << "UFOGRAPH/" << "SMOKE.PCK";
 	s2 << "UFOGRAPH/" << "SMOKE.TAB";
 	_sets["SMOKE.PCK"] = new SurfaceSet(32, 40);
-	_sets["SMOKE.PCK"]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+	loader.addPck(_sets["SMOKE.PCK"], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
 
 	s.str("");
 	s2.str("");
 	s << "UFOGRAPH/" << "X1.PCK";
 	s2 << "UFOGRAPH/" << "X1.TAB";
 	_sets["X1.PCK"] = new SurfaceSet(128, 64);
-	_sets["X1.PCK"]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+	loader.addPck(_sets["X1.PCK"], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
 
 	s.str("");
 	_sets["MEDIBITS.DAT"] = new SurfaceSet(52, 58);
 	s << "UFOGRAPH/" << "MEDIBITS.DAT";
-	_sets["MEDIBITS.DAT"]->loadDat (CrossPlatform::getDataFile(s.str()));
+	loader.addDat(_sets["MEDIBITS.DAT"], CrossPlatform::getDataFile(s.str()));
 
 	s.str("");
 	_sets["DETBLOB.DAT"] = new SurfaceSet(16, 16);
 	s << "UFOGRAPH/" << "DETBLOB.DAT";
-	_sets["DETBLOB.DAT"]->loadDat (CrossPlatform::getDataFile(s.str()));
+	loader.addDat(_sets["DETBLOB.DAT"], CrossPlatform::getDataFile(s.str()));
 
 	// Load Battlescape Terrain (only blacks are loaded, others are loaded just in time)
 	std::string bsets[] = {"BLANKS.PCK"};
@@ -440,7 +476,7 @@ void XcomResourcePack::loadBattlescapeResources()
 		std::stringstream s2;
 		s2 << "TERRAIN/" << tab;
 		_sets[bsets[i]] = new SurfaceSet(32, 40);
-		_sets[bsets[i]]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+		loader.addPck(_sets[bsets[i]], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
 	}
 
 	// Load Battlescape units
@@ -474,14 +510,14 @@ void XcomResourcePack::loadBattlescapeResources()
 		std::stringstream s2;
 		s2 << "UNITS/" << tab;
 		_sets[usets[i]] = new SurfaceSet(32, 40);
-		_sets[usets[i]]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+		loader.addPck(_sets[usets[i]], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
 	}
 	s.str("");
 	s << "UNITS/" << "BIGOBS.PCK";
 	s2.str("");
 	s2 << "UNITS/" << "BIGOBS.TAB";
 	_sets["BIGOBS.PCK"] = new SurfaceSet(32, 48);
-	_sets["BIGOBS.PCK"]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+	loader.addPck(_sets["BIGOBS.PCK"], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
 
 	s.str("");
 	s << "GEODATA/" << "LOFTEMPS.DAT";
@@ -494,7 +530,7 @@ void XcomResourcePack::loadBattlescapeResources()
 		std::stringstream s;
 		s << "UFOGRAPH/" << scrs[i];
 		_surfaces[scrs[i]] = new Surface(320, 200);
-		_surfaces[scrs[i]]->loadScr(CrossPlatform::getDataFile(s.str()));
+		loader.addScr(_surfaces[scrs[i]], CrossPlatform::getDataFile(s.str()));
 	}
 
 	std::string spks[] = {"TAC01.SCR",
@@ -510,7 +546,7 @@ void XcomResourcePack::loadBattlescapeResources()
 		std::stringstream s;
 		s << "UFOGRAPH/" << spks[i];
 		_surfaces[spks[i]] = new Surface(320, 200);
-		_surfaces[spks[i]]->loadSpk(CrossPlatform::getDataFile(s.str()));
+		loader.addSpk(_surfaces[spks[i]], CrossPlatform::getDataFile(s.str()));
 	}
 
 	std::string invs[] = {"MAN_0",
@@ -537,7 +573,7 @@ void XcomResourcePack::loadBattlescapeResources()
 		if (CrossPlatform::fileExists(CrossPlatform::getDataFile(s1full.str())))
 		{
 			_surfaces[s1.str()] = new Surface(320, 200);
-			_surfaces[s1.str()]->loadSpk(CrossPlatform::getDataFile(s1full.str()));
+			loader.addSpk(_surfaces[s1.str()], CrossPlatform::getDataFile(s1full.str()));
 		}
 		// Load gender-based inventory image
 		if (CrossPlatform::fileExists(CrossPlatform::getDataFile(s2full.str())))
@@ -548,10 +584,12 @@ void XcomResourcePack::loadBattlescapeResources()
 				s3 << invs[i] << sets[j] << ".SPK";
 				s3full << "UFOGRAPH/" << s3.str();
 				_surfaces[s3.str()] = new Surface(320, 200);
-				_surfaces[s3.str()]->loadSpk(CrossPlatform::getDataFile(s3full.str()));
+				loader.addSpk(_surfaces[s3.str()], CrossPlatform::getDataFile(s3full.str()));
 			}
 		}
 	}
+
+	loader.run(Options::getInt("loaderThreads"));
 }
 
 }
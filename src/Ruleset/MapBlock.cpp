@@ -17,6 +17,11 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "MapBlock.h"
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include "../Engine/Exception.h"
+#include "../Engine/CrossPlatform.h"
 
 namespace OpenXcom
 {
@@ -24,7 +29,7 @@ namespace OpenXcom
 /**
 * MapBlock construction
 */
-MapBlock::MapBlock(RuleTerrain *terrain, std::string name, int width, int length, MapBlockType type):_terrain(terrain), _name(name), _width(width), _length(length), _height(0), _type(type)
+MapBlock::MapBlock(RuleTerrain *terrain, std::string name, int width, int length, MapBlockType type):_terrain(terrain), _name(name), _width(width), _length(length), _height(0), _type(type), _loaded(false), _hasRoutes(false), _mapWidth(0), _mapLength(0)
 {
 }
 
@@ -139,5 +144,95 @@ MapBlockType MapBlock::getType() const
 	return _type;
 }
 
+/**
+ * Loads the MAP and RMP files of this mapblock into memory. This only
+ * happens the first time the mapblock is used, every mission after
+ * that is generated from memory.
+ * @sa http://www.ufopaedia.org/index.php?title=MAPS
+ * @sa http://www.ufopaedia.org/index.php?title=ROUTES
+ */
+void MapBlock::loadData()
+{
+	// prevents loading twice
+	if (_loaded) return;
+
+	std::stringstream mapName, rmpName;
+	mapName << "MAPS/" << _name << ".MAP";
+	rmpName << "ROUTES/" << _name << ".RMP";
+
+	std::ifstream mapFile (CrossPlatform::getDataFile(mapName.str()).c_str(), std::ios::in | std::ios::binary);
+	if (!mapFile)
+	{
+		throw Exception("Failed to load MAP");
+	}
+
+	char size[3];
+	mapFile.read((char*)&size, sizeof(size));
+	_mapLength = (int)size[0];
+	_mapWidth = (int)size[1];
+	_height = (int)size[2];
+
+	_mapData.assign(std::istreambuf_iterator<char>(mapFile), std::istreambuf_iterator<char>());
+	_mapData.resize(_mapData.size() - _mapData.size() % MAP_RECORD);
+	mapFile.close();
+
+	// landing zones don't need their routes, so only complain when they're actually used
+	std::ifstream rmpFile (CrossPlatform::getDataFile(rmpName.str()).c_str(), std::ios::in | std::ios::binary);
+	_hasRoutes = rmpFile.good();
+	if (_hasRoutes)
+	{
+		_routeData.assign(std::istreambuf_iterator<char>(rmpFile), std::istreambuf_iterator<char>());
+		_routeData.resize(_routeData.size() - _routeData.size() % RMP_RECORD);
+		rmpFile.close();
+	}
+
+	_loaded = true;
+}
+
+/**
+ * Gets the width of the MAP file, which can differ from the ruleset's.
+ * @return width in tiles.
+ */
+int MapBlock::getMapWidth() const
+{
+	return _mapWidth;
+}
+
+/**
+ * Gets the length of the MAP file, which can differ from the ruleset's.
+ * @return length in tiles.
+ */
+int MapBlock::getMapLength() const
+{
+	return _mapLength;
+}
+
+/**
+ * Gets the tiles from the MAP file, top level first, 4 parts per tile.
+ * @return reference to the raw tile records.
+ */
+const std::vector<unsigned char> &MapBlock::getMapData() const
+{
+	return _mapData;
+}
+
+/**
+ * Returns whether an RMP file was found for this mapblock.
+ * @return true if there are routes.
+ */
+bool MapBlock::hasRoutes() const
+{
+	return _hasRoutes;
+}
+
+/**
+ * Gets the nodes from the RMP file, 24 bytes per node.
+ * @return reference to the raw node records.
+ */
+const std::vector<unsigned char> &MapBlock::getRouteData() const
+{
+	return _routeData;
+}
+
 
 }
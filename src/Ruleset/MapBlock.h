@@ -20,6 +20,7 @@
 #define OPENXCOM_MAPBLOCK_H
 
 #include <string>
+#include <vector>
 #include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
@@ -41,7 +42,14 @@ private:
 	std::string _name;
 	int _width, _length, _height;
 	MapBlockType _type;
+	bool _loaded, _hasRoutes;
+	int _mapWidth, _mapLength;
+	std::vector<unsigned char> _mapData, _routeData;
 public:
+	/// Size of a tile in the MAP file.
+	static const int MAP_RECORD = 4;
+	/// Size of a node in the RMP file.
+	static const int RMP_RECORD = 24;
 	MapBlock(RuleTerrain *terrain, std::string name, int width, int length, MapBlockType type);
 	~MapBlock();
 	/// Loads the map block from YAML.
@@ -60,6 +68,18 @@ public:
 	void setHeight(int height);
 	/// Returns whether this mapblock is a landingzone.
 	MapBlockType getType() const;
+	/// Loads the MAP and RMP files of this mapblock.
+	void loadData();
+	/// Gets the width of the MAP file.
+	int getMapWidth() const;
+	/// Gets the length of the MAP file.
+	int getMapLength() const;
+	/// Gets the tiles from the MAP file.
+	const std::vector<unsigned char> &getMapData() const;
+	/// Returns whether this mapblock has an RMP file.
+	bool hasRoutes() const;
+	/// Gets the nodes from the RMP file.
+	const std::vector<unsigned char> &getRouteData() const;
 };
 
 }
@@ -17,12 +17,14 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleResearchProject.h"
+#include "../Engine/IdTable.h"
 
 namespace OpenXcom
 {
 
-RuleResearchProject::RuleResearchProject(const std::string & name, int cost) : _name(name), _cost(cost)
+RuleResearchProject::RuleResearchProject(const std::string & name, int cost) : _name(name), _cost(cost), _needItem(false)
 {
+	_handle = IdTable::intern(name);
 }
 
 /**
@@ -32,6 +34,7 @@ RuleResearchProject::RuleResearchProject(const std::string & name, int cost) : _
 void RuleResearchProject::addDependency (RuleResearchProject * rp)
 {
 	_dependencys.push_back(rp);
+	rp->_requiredBy.push_back(this);
 }
 
 /**
@@ -94,6 +97,34 @@ const std::vector<RuleResearchProject *> & RuleResearchProject::getUnlocked () c
 void RuleResearchProject::addUnlocked (RuleResearchProject * rp)
 {
 	_unlocks.push_back(rp);
+	rp->_unlockedBy.push_back(this);
+}
+
+/**
+   Get the list of ResearchProjects which have this one as a dependency
+   @return the list of ResearchProject which depend on this one
+*/
+const std::vector<RuleResearchProject *> & RuleResearchProject::getRequiredBy () const
+{
+	return _requiredBy;
+}
+
+/**
+   Get the list of ResearchProjects which unlock this one
+   @return the list of ResearchProject which unlock this one
+*/
+const std::vector<RuleResearchProject *> & RuleResearchProject::getUnlockedBy () const
+{
+	return _unlockedBy;
+}
+
+/**
+   Get the handle of this ResearchProject name in the IdTable, used to index research state
+   @return the interned handle of the name
+*/
+int RuleResearchProject::getHandle () const
+{
+	return _handle;
 }
 
 }
@@ -42,7 +42,10 @@ class RuleResearchProject
 	int _cost;
 	std::vector<RuleResearchProject *> _dependencys;
 	std::vector<RuleResearchProject *> _unlocks;
+	std::vector<RuleResearchProject *> _requiredBy;
+	std::vector<RuleResearchProject *> _unlockedBy;
 	bool _needItem;
+	int _handle;
 public:
 	RuleResearchProject(const std::string & name, int cost);
 	/// Add a Dependency
@@ -61,6 +64,12 @@ public:
 	const std::vector<RuleResearchProject *> & getUnlocked () const;
 	/// Add a ResearchProject which can be unlocked
 	void addUnlocked (RuleResearchProject * rp);
+	/// Get the list of ResearchProjects which depend on this research
+	const std::vector<RuleResearchProject *> & getRequiredBy () const;
+	/// Get the list of ResearchProjects which unlock this research
+	const std::vector<RuleResearchProject *> & getUnlockedBy () const;
+	/// Get the interned handle of the research name
+	int getHandle () const;
 };
 }
 
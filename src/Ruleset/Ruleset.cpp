@@ -22,6 +22,7 @@
 #include "../Engine/Options.h"
 #include "../Engine/Exception.h"
 #include "../Engine/CrossPlatform.h"
+#include "../Engine/IdTable.h"
 #include "SoldierNamePool.h"
 #include "RuleCountry.h"
 #include "RuleRegion.h"
@@ -282,6 +283,12 @@ void Ruleset::load(const std::string &filename)
 					rule = new RuleItem(type);
 					_items[type] = rule;
 					_itemsIndex.push_back(type);
+					size_t handle = IdTable::intern(type);
+					if (_itemHandles.size() <= handle)
+					{
+						_itemHandles.resize(handle + 1, 0);
+					}
+					_itemHandles[handle] = rule;
 				}
 				rule->load(*j);
 			}
@@ -698,6 +705,20 @@ RuleItem *const Ruleset::getItem(const std::string &id) const
 		return 0;
 }
 
+/**
+ * Returns the rules for the specified item,
+ * looked up by its interned handle.
+ * @param handle Item handle.
+ * @return Rules for the item, or 0 when the item is not found.
+ */
+RuleItem *const Ruleset::getItem(int handle) const
+{
+	if (handle >= 0 && (size_t)handle < _itemHandles.size())
+		return _itemHandles[handle];
+	else
+		return 0;
+}
+
 /**
  * Returns the list of all items
  * provided by the ruleset.
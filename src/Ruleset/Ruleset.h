@@ -64,6 +64,7 @@ protected:
 	std::map<std::string, RuleCraft*> _crafts;
 	std::map<std::string, RuleCraftWeapon*> _craftWeapons;
 	std::map<std::string, RuleItem*> _items;
+	std::vector<RuleItem*> _itemHandles;
 	std::map<std::string, RuleUfo*> _ufos;
 	std::map<std::string, RuleTerrain*> _terrains;
 	std::map<std::string, MapDataSet*> _mapDataSets;
@@ -109,6 +110,8 @@ public:
 	std::vector<std::string> getCraftWeaponsList() const;
 	/// Gets the ruleset for an item type.
 	RuleItem *const getItem(const std::string &id) const;
+	/// Gets the ruleset for an item handle.
+	RuleItem *const getItem(int handle) const;
 	/// Gets the available items.
 	std::vector<std::string> getItemsList() const;
 	/// Gets the ruleset for a UFO type.
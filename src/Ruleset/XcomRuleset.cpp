@@ -798,6 +798,7 @@ SavedGame *XcomRuleset::newSave(GameDifficulty diff) const
 	base->getFacilities()->push_back(new BaseFacility(getBaseFacility("STR_LABORATORY"), base, 3, 3));
 	base->getFacilities()->push_back(new BaseFacility(getBaseFacility("STR_WORKSHOP"), base, 4, 3));
 	base->getFacilities()->push_back(new BaseFacility(getBaseFacility("STR_SMALL_RADAR_SYSTEM"), base, 1, 3));
+	base->updateFacilities();
 
 	// Add items
 	base->getItems()->addItem("STR_STINGRAY_LAUNCHER", 1);
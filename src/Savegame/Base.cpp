@@ -18,6 +18,7 @@
  */
 #include "Base.h"
 #include <cmath>
+#include <cassert>
 #include "BaseFacility.h"
 #include "../Ruleset/RuleBaseFacility.h"
 #include "Craft.h"
@@ -45,7 +46,7 @@ namespace OpenXcom
  * Initializes an empty base.
  * @param rule Pointer to ruleset.
  */
-Base::Base(const Ruleset *rule) : Target(), _rule(rule), _name(L""), _facilities(), _soldiers(), _crafts(), _scientists(0), _engineers(0)
+Base::Base(const Ruleset *rule) : Target(), _rule(rule), _name(L""), _facilities(), _soldiers(), _crafts(), _scientists(0), _engineers(0), _capacity()
 {
 	_items = new ItemContainer();
 }
@@ -101,6 +102,7 @@ void Base::load(const YAML::Node &node, SavedGame *save)
 		f->load(*i);
 		_facilities.push_back(f);
 	}
+	updateFacilities();
 
 	for (YAML::Iterator i = node["crafts"].begin(); i != node["crafts"].end(); ++i)
 	{
@@ -301,6 +303,71 @@ std::vector<BaseFacility*> *const Base::getFacilities()
 	return &_facilities;
 }
 
+/**
+ * Adds up everything provided by the finished facilities
+ * in the base, going through all of them.
+ * @param capacity Pointer to the totals to fill in.
+ */
+void Base::calculateCapacity(BaseCapacity *capacity) const
+{
+	BaseCapacity total = BaseCapacity();
+	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
+	{
+		if ((*i)->getBuildTime() == 0)
+		{
+			RuleBaseFacility *rule = (*i)->getRules();
+			total.quarters += rule->getPersonnel();
+			total.stores += rule->getStorage();
+			total.laboratories += rule->getLaboratories();
+			total.workshops += rule->getWorkshops();
+			total.hangars += rule->getCrafts();
+			total.defence += rule->getDefenceValue();
+			if (rule->getRadarRange() == 1500)
+			{
+				total.shortDetection++;
+			}
+			else if (rule->getRadarRange() > 1500)
+			{
+				total.longDetection++;
+			}
+			total.maintenance += rule->getMonthlyCost();
+		}
+	}
+	*capacity = total;
+}
+
+/**
+ * Recalculates the totals provided by the base facilities.
+ * Needs to be called whenever facilities are added, removed
+ * or finish building, so the totals can be read directly.
+ */
+void Base::updateFacilities()
+{
+	calculateCapacity(&_capacity);
+}
+
+/**
+ * Makes sure the cached facility totals match the actual
+ * facilities, to catch any changes that didn't update them.
+ * Only checked in debug builds.
+ */
+void Base::validateCapacity() const
+{
+#ifdef _DEBUG
+	BaseCapacity actual;
+	calculateCapacity(&actual);
+	assert(actual.quarters == _capacity.quarters);
+	assert(actual.stores == _capacity.stores);
+	assert(actual.laboratories == _capacity.laboratories);
+	assert(actual.workshops == _capacity.workshops);
+	assert(actual.hangars == _capacity.hangars);
+	assert(actual.defence == _capacity.defence);
+	assert(actual.shortDetection == _capacity.shortDetection);
+	assert(actual.longDetection == _capacity.longDetection);
+	assert(actual.maintenance == _capacity.maintenance);
+#endif
+}
+
 /**
  * Returns the list of soldiers in the base.
  * @return Pointer to the soldier list.
@@ -494,15 +561,8 @@ int Base::getUsedQuarters() const
  */
 int Base::getAvailableQuarters() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getPersonnel();
-		}
-	}
-	return total;
+	validateCapacity();
+	return _capacity.quarters;
 }
 
 /**
@@ -534,15 +594,8 @@ int Base::getUsedStores() const
  */
 int Base::getAvailableStores() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getStorage();
-		}
-	}
-	return total;
+	validateCapacity();
+	return _capacity.stores;
 }
 
 /**
@@ -570,15 +623,8 @@ int Base::getUsedLaboratories() const
  */
 int Base::getAvailableLaboratories() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getLaboratories();
-		}
-	}
-	return total;
+	validateCapacity();
+	return _capacity.laboratories;
 }
 
 /**
@@ -603,15 +649,8 @@ int Base::getUsedWorkshops() const
  */
 int Base::getAvailableWorkshops() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getWorkshops();
-		}
-	}
-	return total;
+	validateCapacity();
+	return _capacity.workshops;
 }
 
 /**
@@ -639,15 +678,8 @@ int Base::getUsedHangars() const
  */
 int Base::getAvailableHangars() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getCrafts();
-		}
-	}
-	return total;
+	validateCapacity();
+	return _capacity.hangars;
 }
 
 /**
@@ -706,15 +738,8 @@ int Base::getAllocatedEngineers() const
  */
 int Base::getDefenceValue() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getDefenceValue();
-		}
-	}
-	return total;
+	validateCapacity();
+	return _capacity.defence;
 }
 
 /**
@@ -724,15 +749,8 @@ int Base::getDefenceValue() const
  */
 int Base::getShortRangeDetection() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0 && (*i)->getRules()->getRadarRange() == 1500)
-		{
-			total++;
-		}
-	}
-	return total;
+	validateCapacity();
+	return _capacity.shortDetection;
 }
 
 /**
@@ -742,15 +760,8 @@ int Base::getShortRangeDetection() const
  */
 int Base::getLongRangeDetection() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0 && (*i)->getRules()->getRadarRange() > 1500)
-		{
-			total++;
-		}
-	}
-	return total;
+	validateCapacity();
+	return _capacity.longDetection;
 }
 
 /**
@@ -808,15 +819,8 @@ int Base::getPersonnelMaintenance() const
  */
 int Base::getFacilityMaintenance() const
 {
-	int total = 0;
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
-	{
-		if ((*i)->getBuildTime() == 0)
-		{
-			total += (*i)->getRules()->getMonthlyCost();
-		}
-	}
-	return total;
+	validateCapacity();
+	return _capacity.maintenance;
 }
 
 /**
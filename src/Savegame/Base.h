@@ -39,6 +39,16 @@ class SavedGame;
 class ResearchProject;
 class Production;
 
+/**
+ * Totals of everything provided by the
+ * finished facilities in a base.
+ */
+struct BaseCapacity
+{
+	int quarters, stores, laboratories, workshops, hangars;
+	int defence, shortDetection, longDetection, maintenance;
+};
+
 /**
  * Represents a player base on the globe.
  * Bases can contain facilities, personnel, crafts and equipment.
@@ -56,6 +66,12 @@ private:
 	int _scientists, _engineers;
 	std::vector<ResearchProject *> _research;
 	std::vector<Production *> _productions;
+	BaseCapacity _capacity;
+
+	/// Calculates the base's facility totals from scratch.
+	void calculateCapacity(BaseCapacity *capacity) const;
+	/// Checks the cached facility totals are correct.
+	void validateCapacity() const;
 public:
 	/// Creates a new base.
 	Base(const Ruleset *rule);
@@ -73,6 +89,8 @@ public:
 	void setName(const std::wstring &name);
 	/// Gets the base's facilities.
 	std::vector<BaseFacility*> *const getFacilities();
+	/// Updates the base's facility totals.
+	void updateFacilities();
 	/// Gets the base's soldiers.
 	std::vector<Soldier*> *const getSoldiers();
 	/// Gets the base's crafts.
@@ -120,10 +120,16 @@ void BaseFacility::setBuildTime(int time)
 
 /**
  * Handles the facility building every day.
+ * Once finished, the facility starts counting
+ * towards the base's totals.
  */
 void BaseFacility::build()
 {
 	_buildTime--;
+	if (_buildTime == 0 && _base != 0)
+	{
+		_base->updateFacilities();
+	}
 }
 
 /**
@@ -32,7 +32,7 @@ Country::Country(RuleCountry *rules, bool gen) : _rules(rules), _funding(0), _ch
 {
 	if (gen)
 	{
-		_funding = RNG::generate(rules->getMinFunding(), rules->getMaxFunding()) * 1000;
+		_funding = RNG::generate(RNG::STREAM_GEOSCAPE, rules->getMinFunding(), rules->getMaxFunding()) * 1000;
 	}
 }
 
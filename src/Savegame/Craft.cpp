@@ -32,6 +32,9 @@
 namespace OpenXcom
 {
 
+const int CRAFT_STATUS_COUNT = 5;
+const char *const CRAFT_STATUS_STRINGS[CRAFT_STATUS_COUNT] = {"STR_READY", "STR_OUT", "STR_REFUELLING", "STR_REARMING", "STR_REPAIRS"};
+
 /**
  * Initializes a craft of the specified type and
  * assigns it the latest craft ID available.
@@ -39,7 +42,7 @@ namespace OpenXcom
  * @param base Pointer to base of origin.
  * @param ids List of craft IDs (Leave NULL for no ID).
  */
-Craft::Craft(RuleCraft *rules, Base *base, std::map<std::string, int> *ids) : MovingTarget(), _rules(rules), _base(base), _id(0), _fuel(0), _damage(0), _weapons(), _status("STR_READY"), _lowFuel(false), _inBattlescape(false)
+Craft::Craft(RuleCraft *rules, Base *base, std::map<std::string, int> *ids) : MovingTarget(), _rules(rules), _base(base), _id(0), _fuel(0), _damage(0), _weapons(), _status(CRAFT_READY), _lowFuel(false), _inBattlescape(false)
 {
 	_items = new ItemContainer();
 	if (ids != 0)
@@ -91,7 +94,16 @@ void Craft::load(const YAML::Node &node, const Ruleset *rule)
 	}
 
 	_items->load(node["items"]);
-	node["status"] >> _status;
+	std::string status;
+	node["status"] >> status;
+	_status = CRAFT_READY;
+	for (int i = 0; i < CRAFT_STATUS_COUNT; ++i)
+	{
+		if (status == CRAFT_STATUS_STRINGS[i])
+		{
+			_status = (CraftStatus)i;
+		}
+	}
 	node["lowFuel"] >> _lowFuel;
 	node["inBattlescape"] >> _inBattlescape;
 }
@@ -125,7 +137,7 @@ void Craft::save(YAML::Emitter &out) const
 	out << YAML::EndSeq;
 	out << YAML::Key << "items" << YAML::Value;
 	_items->save(out);
-	out << YAML::Key << "status" << YAML::Value << _status;
+	out << YAML::Key << "status" << YAML::Value << getStatusString();
 	out << YAML::Key << "lowFuel" << YAML::Value << _lowFuel;
 	out << YAML::Key << "inBattlescape" << YAML::Value << _inBattlescape;
 	out << YAML::EndMap;
@@ -194,18 +206,28 @@ void Craft::setBase(Base *base)
 
 /**
  * Returns the current status of the craft.
- * @return Status string.
+ * @return Status.
  */
-std::string Craft::getStatus() const
+CraftStatus Craft::getStatus() const
 {
 	return _status;
 }
 
+/**
+ * Returns the string ID of the current status of the
+ * craft, used for saving and displaying it.
+ * @return Status string.
+ */
+std::string Craft::getStatusString() const
+{
+	return CRAFT_STATUS_STRINGS[_status];
+}
+
 /**
  * Changes the current status of the craft.
- * @param status Status string.
+ * @param status Status.
  */
-void Craft::setStatus(const std::string &status)
+void Craft::setStatus(CraftStatus status)
 {
 	_status = status;
 }
@@ -462,15 +484,15 @@ void Craft::think()
 
 		if (_damage > 0)
 		{
-			_status = "STR_REPAIRS";
+			_status = CRAFT_REPAIRS;
 		}
 		else if (available != full)
 		{
-			_status = "STR_REARMING";
+			_status = CRAFT_REARMING;
 		}
 		else
 		{
-			_status = "STR_REFUELLING";
+			_status = CRAFT_REFUELLING;
 		}
 		setSpeed(0);
 		setDestination(0);
@@ -510,7 +532,7 @@ void Craft::repair()
 	setDamage(_damage - _rules->getRepairRate());
 	if (_damage <= 0)
 	{
-		_status = "STR_REARMING";
+		_status = CRAFT_REARMING;
 	}
 }
 
@@ -523,7 +545,7 @@ void Craft::refuel()
 	setFuel(_fuel + _rules->getRefuelRate());
 	if (_fuel >= _rules->getMaxFuel())
 	{
-		_status = "STR_READY";
+		_status = CRAFT_READY;
 	}
 }
 
@@ -539,7 +561,7 @@ std::string Craft::rearm()
 	{
 		if (i == _weapons.end())
 		{
-			_status = "STR_REFUELLING";
+			_status = CRAFT_REFUELLING;
 			break;
 		}
 		if (*i != 0 && (*i)->isRearming())
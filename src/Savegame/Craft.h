@@ -33,6 +33,8 @@ class CraftWeapon;
 class ItemContainer;
 class Ruleset;
 
+enum CraftStatus { CRAFT_READY, CRAFT_OUT, CRAFT_REFUELLING, CRAFT_REARMING, CRAFT_REPAIRS };
+
 /**
  * Represents a craft stored in a base.
  * Contains variable info about a craft like
@@ -47,7 +49,7 @@ private:
 	int _id, _fuel, _damage;
 	std::vector<CraftWeapon*> _weapons;
 	ItemContainer *_items;
-	std::string _status;
+	CraftStatus _status;
 	bool _lowFuel;
 	bool _inBattlescape;
 public:
@@ -72,9 +74,11 @@ public:
 	/// Sets the craft's base.
 	void setBase(Base *base);
 	/// Gets the craft's status.
-	std::string getStatus() const;
+	CraftStatus getStatus() const;
+	/// Gets the craft's status string ID.
+	std::string getStatusString() const;
 	/// Sets the craft's status.
-	void setStatus(const std::string &status);
+	void setStatus(CraftStatus status);
 	/// Sets the craft's destination.
 	void setDestination(Target *dest);
 	/// Gets the craft's amount of weapons.
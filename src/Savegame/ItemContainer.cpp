@@ -19,6 +19,7 @@
 #include "ItemContainer.h"
 #include "../Ruleset/Ruleset.h"
 #include "../Ruleset/RuleItem.h"
+#include "../Engine/IdTable.h"
 
 namespace OpenXcom
 {
@@ -26,7 +27,7 @@ namespace OpenXcom
 /**
  * Initializes an item container with no contents.
  */
-ItemContainer::ItemContainer() : _qty()
+ItemContainer::ItemContainer() : _qty(), _size(0), _sizeValid(false)
 {
 }
 
@@ -43,7 +44,12 @@ ItemContainer::~ItemContainer()
  */
 void ItemContainer::load(const YAML::Node &node)
 {
-	node >> _qty;
+	std::map<std::string, int> qty;
+	node >> qty;
+	for (std::map<std::string, int>::const_iterator i = qty.begin(); i != qty.end(); ++i)
+	{
+		addItem(i->first, i->second);
+	}
 }
 
 /**
@@ -52,7 +58,7 @@ void ItemContainer::load(const YAML::Node &node)
  */
 void ItemContainer::save(YAML::Emitter &out) const
 {
-	out << _qty;
+	out << getContents();
 }
 
 /**
@@ -66,11 +72,26 @@ void ItemContainer::addItem(const std::string &id, int qty)
 	{
 		return;
 	}
-	if (_qty.find(id) == _qty.end())
+	addItem(IdTable::intern(id), qty);
+}
+
+/**
+ * Adds an item amount to the container.
+ * @param handle Item handle.
+ * @param qty Item quantity.
+ */
+void ItemContainer::addItem(int handle, int qty)
+{
+	if (handle < 0)
+	{
+		return;
+	}
+	if (_qty.size() <= (size_t)handle)
 	{
-		_qty[id] = 0;
+		_qty.resize(handle + 1, 0);
 	}
-	_qty[id] += qty;
+	_qty[handle] += qty;
+	_sizeValid = false;
 }
 
 /**
@@ -80,18 +101,33 @@ void ItemContainer::addItem(const std::string &id, int qty)
  */
 void ItemContainer::removeItem(const std::string &id, int qty)
 {
-	if (id.empty() || _qty.find(id) == _qty.end())
+	if (id.empty())
+	{
+		return;
+	}
+	removeItem(IdTable::find(id), qty);
+}
+
+/**
+ * Removes an item amount from the container.
+ * @param handle Item handle.
+ * @param qty Item quantity.
+ */
+void ItemContainer::removeItem(int handle, int qty)
+{
+	if (handle < 0 || (size_t)handle >= _qty.size())
 	{
 		return;
 	}
-	if (qty < _qty[id])
+	if (qty < _qty[handle])
 	{
-		_qty[id] -= qty;
+		_qty[handle] -= qty;
 	}
 	else
 	{
-		_qty.erase(id);
+		_qty[handle] = 0;
 	}
+	_sizeValid = false;
 }
 
 /**
@@ -105,16 +141,21 @@ int ItemContainer::getItem(const std::string &id) const
 	{
 		return 0;
 	}
+	return getItem(IdTable::find(id));
+}
 
-	std::map<std::string, int>::const_iterator it = _qty.find(id);
-	if (it == _qty.end())
+/**
+ * Returns the quantity of an item in the container.
+ * @param handle Item handle.
+ * @return Item quantity.
+ */
+int ItemContainer::getItem(int handle) const
+{
+	if (handle < 0 || (size_t)handle >= _qty.size())
 	{
 		return 0;
 	}
-	else
-	{
-		return it->second;
-	}
+	return _qty[handle];
 }
 
 /**
@@ -124,35 +165,62 @@ int ItemContainer::getItem(const std::string &id) const
 int ItemContainer::getTotalQuantity() const
 {
 	int total = 0;
-	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	for (std::vector<int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
 	{
-		total += i->second;
+		total += *i;
 	}
 	return total;
 }
 
 /**
  * Returns the total size of the items in the container.
+ * The total is kept until the contents change.
  * @param rule Pointer to ruleset.
  * @return Total item size.
  */
 double ItemContainer::getTotalSize(const Ruleset *rule) const
 {
-	double total = 0;
-	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	if (!_sizeValid)
 	{
-		total += rule->getItem(i->first)->getSize() * i->second;
+		_size = 0;
+		for (size_t i = 0; i < _qty.size(); ++i)
+		{
+			if (_qty[i] != 0)
+			{
+				_size += rule->getItem((int)i)->getSize() * _qty[i];
+			}
+		}
+		_sizeValid = true;
 	}
-	return total;
+	return _size;
 }
 
 /**
- * Returns all the items currently contained within.
+ * Returns all the items currently contained within,
+ * sorted by item ID.
  * @return List of contents.
  */
-std::map<std::string, int> *const ItemContainer::getContents()
+std::map<std::string, int> ItemContainer::getContents() const
+{
+	std::map<std::string, int> contents;
+	for (size_t i = 0; i < _qty.size(); ++i)
+	{
+		if (_qty[i] != 0)
+		{
+			contents[IdTable::getString((int)i)] = _qty[i];
+		}
+	}
+	return contents;
+}
+
+/**
+ * Removes all the items currently contained within.
+ */
+void ItemContainer::clear()
 {
-	return &_qty;
+	_qty.clear();
+	_size = 0;
+	_sizeValid = true;
 }
 
 }
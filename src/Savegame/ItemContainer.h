@@ -21,6 +21,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
@@ -32,11 +33,14 @@ class Ruleset;
  * Represents the items contained by a certain entity,
  * like base stores, craft equipment, etc.
  * Handles all necessary item management tasks.
+ * Quantities are indexed by interned item handle.
  */
 class ItemContainer
 {
 private:
-	std::map<std::string, int> _qty;
+	std::vector<int> _qty;
+	mutable double _size;
+	mutable bool _sizeValid;
 public:
 	/// Creates an empty item container.
 	ItemContainer();
@@ -48,16 +52,24 @@ public:
 	void save(YAML::Emitter& out) const;
 	/// Adds an item to the container.
 	void addItem(const std::string &id, int qty = 1);
+	/// Adds an item to the container by handle.
+	void addItem(int handle, int qty = 1);
 	/// Removes an item from the container.
 	void removeItem(const std::string &id, int qty = 1);
+	/// Removes an item from the container by handle.
+	void removeItem(int handle, int qty = 1);
 	/// Gets an item in the container.
 	int getItem(const std::string &id) const;
+	/// Gets an item in the container by handle.
+	int getItem(int handle) const;
 	/// Gets the total quantity of items in the container.
 	int getTotalQuantity() const;
 	/// Gets the total size of items in the container.
 	double getTotalSize(const Ruleset *rule) const;
 	/// Gets all the items in the container.
-	std::map<std::string, int> *const getContents();
+	std::map<std::string, int> getContents() const;
+	/// Removes all the items from the container.
+	void clear();
 };
 
 }
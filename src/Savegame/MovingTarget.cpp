@@ -26,7 +26,7 @@ namespace OpenXcom
 /**
  * Initializes a moving target with blank coordinates.
  */
-MovingTarget::MovingTarget() : Target(), _dest(0), _speedLon(0.0), _speedLat(0.0), _speedRadian(0.0), _speed(0)
+MovingTarget::MovingTarget() : Target(), _dest(0), _speedLon(0.0), _speedLat(0.0), _speedRadian(0.0), _speed(0), _arcValid(false), _arcLength(0.0), _arcTravelled(0.0), _arcDestLon(0.0), _arcDestLat(0.0)
 {
 }
 
@@ -125,27 +125,165 @@ void MovingTarget::setSpeed(int speed)
 	calculateSpeed();
 }
 
+/**
+ * Converts polar coordinates into a unit vector
+ * from the center of the globe.
+ * @param lon Longitude in radian.
+ * @param lat Latitude in radian.
+ * @param v Pointer to the resulting vector.
+ */
+static void polarToVector(double lon, double lat, double *v)
+{
+	v[0] = cos(lat) * cos(lon);
+	v[1] = cos(lat) * sin(lon);
+	v[2] = sin(lat);
+}
+
+/**
+ * Plans the great circle arc between two points on the globe,
+ * so that the point reached after travelling a distance D along
+ * the arc is simply start * cos(D) + tangent * sin(D).
+ * @param lon Starting longitude in radian.
+ * @param lat Starting latitude in radian.
+ * @param destLon Destination longitude in radian.
+ * @param destLat Destination latitude in radian.
+ * @param start Pointer to the resulting start vector.
+ * @param tangent Pointer to the resulting tangent vector.
+ * @return Arc length in radian.
+ */
+static double planArc(double lon, double lat, double destLon, double destLat, double *start, double *tangent)
+{
+	double dest[3];
+	polarToVector(lon, lat, start);
+	polarToVector(destLon, destLat, dest);
+	double dot = start[0] * dest[0] + start[1] * dest[1] + start[2] * dest[2];
+	for (int i = 0; i < 3; ++i)
+	{
+		tangent[i] = dest[i] - dot * start[i];
+	}
+	double norm = sqrt(tangent[0] * tangent[0] + tangent[1] * tangent[1] + tangent[2] * tangent[2]);
+	if (norm < 1e-12)
+	{
+		// Destination is right here (or right across the globe),
+		// any heading will do so just go north
+		tangent[0] = -sin(lat) * cos(lon);
+		tangent[1] = -sin(lat) * sin(lon);
+		tangent[2] = cos(lat);
+	}
+	else
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			tangent[i] /= norm;
+		}
+	}
+	return atan2(norm, dot);
+}
+
+/**
+ * Gets the position and heading at a certain distance along a planned arc.
+ * @param start Pointer to the arc start vector.
+ * @param tangent Pointer to the arc tangent vector.
+ * @param travelled Distance travelled along the arc in radian.
+ * @param pos Pointer to the resulting position vector.
+ * @param vel Pointer to the resulting heading vector (can be null).
+ */
+static void arcPoint(const double *start, const double *tangent, double travelled, double *pos, double *vel)
+{
+	double c = cos(travelled), s = sin(travelled);
+	for (int i = 0; i < 3; ++i)
+	{
+		pos[i] = start[i] * c + tangent[i] * s;
+		if (vel != 0)
+			vel[i] = tangent[i] * c - start[i] * s;
+	}
+}
+
+/**
+ * Converts a unit vector from the center of the globe
+ * back into polar coordinates.
+ * @param v Pointer to the vector.
+ * @param lon Pointer to the resulting longitude in radian.
+ * @param lat Pointer to the resulting latitude in radian.
+ */
+static void vectorToPolar(const double *v, double *lon, double *lat)
+{
+	double z = v[2];
+	if (z > 1.0)
+		z = 1.0;
+	else if (z < -1.0)
+		z = -1.0;
+	*lon = atan2(v[1], v[0]);
+	if (*lon < 0)
+		*lon += 2 * M_PI;
+	*lat = asin(z);
+}
+
+/**
+ * Plans the great circle arc from the current position to
+ * the destination. The arc is only replanned when the
+ * destination changes, so every movement afterwards is just
+ * a point along a known path.
+ */
+void MovingTarget::calculateArc()
+{
+	if (_dest == 0)
+	{
+		_arcValid = false;
+		return;
+	}
+	_arcDestLon = _dest->getLongitude();
+	_arcDestLat = _dest->getLatitude();
+	_arcLength = planArc(_lon, _lat, _arcDestLon, _arcDestLat, _arcStart, _arcTangent);
+	_arcTravelled = 0.0;
+	_arcValid = true;
+}
+
+/**
+ * Checks if the destination has moved away from
+ * where it was when the current arc was planned.
+ * @return True if it has, False otherwise.
+ */
+bool MovingTarget::destinationMoved() const
+{
+	return (_dest->getLongitude() != _arcDestLon || _dest->getLatitude() != _arcDestLat);
+}
+
+/**
+ * Converts a heading along the arc into the speed
+ * vector in longitude and latitude per 5 seconds.
+ * @param pos Pointer to the current position vector.
+ * @param vel Pointer to the current heading vector.
+ */
+void MovingTarget::calculateHeading(const double *pos, const double *vel)
+{
+	double cosLat = sqrt(pos[0] * pos[0] + pos[1] * pos[1]);
+	if (cosLat < 1e-12)
+	{
+		// Longitude is meaningless at the poles
+		_speedLon = 0;
+		_speedLat = (vel[2] > 0 ? 1 : -1) * _speedRadian;
+		return;
+	}
+	double sinLat = pos[2];
+	double cosLon = pos[0] / cosLat, sinLon = pos[1] / cosLat;
+	double east = -sinLon * vel[0] + cosLon * vel[1];
+	double north = -sinLat * cosLon * vel[0] - sinLat * sinLon * vel[1] + cosLat * vel[2];
+	_speedLon = east * _speedRadian / cosLat;
+	_speedLat = north * _speedRadian;
+}
+
 /**
  * Calculates the speed vector based on the
- * great circle distance to destination and
+ * great circle arc to the destination and
  * current raw speed.
  */
 void MovingTarget::calculateSpeed()
 {
-	if (_dest != 0)
+	calculateArc();
+	if (_arcValid)
 	{
-		double dLon, dLat, length;
-		dLon = sin(_dest->getLongitude() - _lon) * cos(_dest->getLatitude());
-		dLat = cos(_lat) * sin(_dest->getLatitude()) - sin(_lat) * cos(_dest->getLatitude()) * cos(_dest->getLongitude() - _lon);
-		length = sqrt(dLon * dLon + dLat * dLat);
-		_speedLon = dLon / length * _speedRadian / cos(_lat + _speedLat);
-		_speedLat = dLat / length * _speedRadian;
-		// Check for invalid speeds
-		if (!(_speedLon == _speedLon) || !(_speedLat == _speedLat))
-		{
-			_speedLon = 0;
-			_speedLat = 0;
-		}
+		calculateHeading(_arcStart, _arcTangent);
 	}
 	else
 	{
@@ -164,27 +302,124 @@ bool MovingTarget::reachedDestination() const
 	{
 		return false;
 	}
-	return (_lon == _dest->getLongitude() && _lat == _dest->getLatitude());
+	if (!_arcValid || destinationMoved())
+	{
+		return (_lon == _dest->getLongitude() && _lat == _dest->getLatitude());
+	}
+	return (_arcTravelled >= _arcLength);
 }
 
 /**
- * Executes a movement cycle for the moving target.
+ * Returns how long the moving target will take to reach
+ * its destination at the current speed, assuming the
+ * destination stays where it is.
+ * @return Time in 5-second steps, or -1 if it never gets there.
  */
-void MovingTarget::move()
+double MovingTarget::getTimeToDestination() const
 {
-	calculateSpeed();
-	if (_dest != 0)
+	if (_dest == 0)
 	{
-		if (getDistance(_dest) > _speedRadian)
-		{
-			setLongitude(_lon + _speedLon);
-			setLatitude(_lat + _speedLat);
-		}
-		else
+		return -1;
+	}
+	double remaining;
+	if (!_arcValid || destinationMoved())
+	{
+		double start[3], tangent[3];
+		remaining = planArc(_lon, _lat, _dest->getLongitude(), _dest->getLatitude(), start, tangent);
+	}
+	else
+	{
+		remaining = _arcLength - _arcTravelled;
+	}
+	if (remaining <= 0)
+	{
+		return 0;
+	}
+	if (_speedRadian <= 0)
+	{
+		return -1;
+	}
+	return remaining / _speedRadian;
+}
+
+/**
+ * Returns where the moving target will be after a certain time
+ * at the current speed, assuming the destination stays where it is.
+ * @param time Time in 5-second steps.
+ * @param lon Pointer to the resulting longitude in radian.
+ * @param lat Pointer to the resulting latitude in radian.
+ */
+void MovingTarget::getPositionAt(double time, double *lon, double *lat) const
+{
+	if (_dest == 0)
+	{
+		*lon = _lon;
+		*lat = _lat;
+		return;
+	}
+	double start[3], tangent[3], length, travelled;
+	if (!_arcValid || destinationMoved())
+	{
+		length = planArc(_lon, _lat, _dest->getLongitude(), _dest->getLatitude(), start, tangent);
+		travelled = 0.0;
+	}
+	else
+	{
+		for (int i = 0; i < 3; ++i)
 		{
-			setLongitude(_dest->getLongitude());
-			setLatitude(_dest->getLatitude());
+			start[i] = _arcStart[i];
+			tangent[i] = _arcTangent[i];
 		}
+		length = _arcLength;
+		travelled = _arcTravelled;
+	}
+	travelled += _speedRadian * time;
+	if (travelled >= length)
+	{
+		*lon = _dest->getLongitude();
+		*lat = _dest->getLatitude();
+	}
+	else
+	{
+		double pos[3];
+		arcPoint(start, tangent, travelled, pos, 0);
+		vectorToPolar(pos, lon, lat);
+	}
+}
+
+/**
+ * Executes a movement cycle for the moving target.
+ * Since the path is a known arc, several cycles can
+ * be done at once for the same cost as a single one.
+ * @param steps Number of 5-second steps to move.
+ */
+void MovingTarget::move(int steps)
+{
+	if (_dest == 0)
+	{
+		_speedLon = 0;
+		_speedLat = 0;
+		return;
+	}
+	if (!_arcValid || destinationMoved())
+	{
+		calculateSpeed();
+	}
+	_arcTravelled += _speedRadian * steps;
+	if (_arcTravelled >= _arcLength)
+	{
+		_arcTravelled = _arcLength;
+		setLongitude(_arcDestLon);
+		setLatitude(_arcDestLat);
+	}
+	else
+	{
+		double pos[3], vel[3], lon, lat;
+		arcPoint(_arcStart, _arcTangent, _arcTravelled, pos, vel);
+		vectorToPolar(pos, &lon, &lat);
+		setLongitude(lon);
+		setLatitude(lat);
+		calculateHeading(pos, vel);
 	}
 }
 
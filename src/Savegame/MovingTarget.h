@@ -36,9 +36,18 @@ protected:
 	Target *_dest;
 	double _speedLon, _speedLat, _speedRadian;
 	int _speed;
+	bool _arcValid;
+	double _arcStart[3], _arcTangent[3];
+	double _arcLength, _arcTravelled, _arcDestLon, _arcDestLat;
 
 	/// Calculates a new speed vector to the destination.
 	virtual void calculateSpeed();
+	/// Plans the great circle arc to the destination.
+	void calculateArc();
+	/// Checks if the destination moved since the arc was planned.
+	bool destinationMoved() const;
+	/// Updates the speed vector to match the arc heading.
+	void calculateHeading(const double *pos, const double *vel);
 public:
 	/// Creates a moving target.
 	MovingTarget();
@@ -58,8 +67,12 @@ public:
 	void setSpeed(int speed);
 	/// Has the moving target reached its destination?
 	bool reachedDestination() const;
+	/// Gets the time left until the destination is reached.
+	double getTimeToDestination() const;
+	/// Gets the moving target's position after a certain time.
+	void getPositionAt(double time, double *lon, double *lat) const;
 	/// Move towards the destination.
-	void move();
+	void move(int steps = 1);
 };
 
 }
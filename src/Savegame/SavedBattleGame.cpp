@@ -22,9 +22,14 @@
 #include "Tile.h"
 #include "Node.h"
 #include <SDL.h>
+#include <sstream>
+#include <map>
+#include <algorithm>
 #include "../Ruleset/MapDataSet.h"
 #include "../Battlescape/Pathfinding.h"
 #include "../Battlescape/TileEngine.h"
+#include "../Battlescape/ThreatMap.h"
+#include "../Battlescape/NodeGraph.h"
 #include "../Battlescape/Position.h"
 #include "../Resource/ResourcePack.h"
 #include "../Ruleset/Ruleset.h"
@@ -34,16 +39,53 @@
 #include "../Battlescape/PatrolBAIState.h"
 #include "../Battlescape/AggroBAIState.h"
 #include "../Engine/RNG.h"
+#include "../Engine/Exception.h"
+#include "../Engine/JobSystem.h"
 #include "../Savegame/NodeLink.h"
 
 
 namespace OpenXcom
 {
 
+/**
+ * Collects the tiles on fire and the tiles with smoke in a range of the map.
+ */
+class BurningTileTask : public ParallelTask
+{
+private:
+	Tile **_tiles;
+	std::vector<std::vector<Tile*> > _fire, _smoke;
+public:
+	BurningTileTask(Tile **tiles, int chunks) : _tiles(tiles), _fire(chunks), _smoke(chunks) {}
+	void run(int chunk, int begin, int end)
+	{
+		for (int i = begin; i < end; ++i)
+		{
+			if (_tiles[i]->getFire() > 0)
+			{
+				_fire[chunk].push_back(_tiles[i]);
+			}
+			if (_tiles[i]->getSmoke() > 0)
+			{
+				_smoke[chunk].push_back(_tiles[i]);
+			}
+		}
+	}
+	/// Gets the tiles on fire and the tiles with smoke, in tile order.
+	void getTiles(std::vector<Tile*> *fire, std::vector<Tile*> *smoke) const
+	{
+		for (size_t i = 0; i < _fire.size(); ++i)
+		{
+			fire->insert(fire->end(), _fire[i].begin(), _fire[i].end());
+			smoke->insert(smoke->end(), _smoke[i].begin(), _smoke[i].end());
+		}
+	}
+};
+
 /**
  * Initializes a brand new battlescape saved game.
  */
-SavedBattleGame::SavedBattleGame() : _tiles(), _selectedUnit(0), _nodes(), _units(), _items(), _pathfinding(0), _tileEngine(0), _missionType(""), _side(FACTION_PLAYER), _turn(1), _debugMode(false), _aborted(false), _itemId(0)
+SavedBattleGame::SavedBattleGame() : _tiles(), _selectedUnit(0), _nodes(), _units(), _items(), _pathfinding(0), _tileEngine(0), _threatMap(0), _nodeGraph(0), _missionType(""), _side(FACTION_PLAYER), _turn(1), _debugMode(false), _aborted(false), _itemId(0)
 {
 }
 
@@ -75,6 +117,8 @@ SavedBattleGame::~SavedBattleGame()
 
 	delete _pathfinding;
 	delete _tileEngine;
+	delete _threatMap;
+	delete _nodeGraph;
 }
 
 /**
@@ -104,13 +148,23 @@ void SavedBattleGame::load(const YAML::Node &node, Ruleset *rule, SavedGame* sav
 
 	initMap(_width, _length, _height);
 
-	for (YAML::Iterator i = node["tiles"].begin(); i != node["tiles"].end(); ++i)
+	if (const YAML::Node *pTiles = node.FindValue("tileData"))
 	{
-		Position pos;
-		(*i)["position"][0] >> pos.x;
-		(*i)["position"][1] >> pos.y;
-		(*i)["position"][2] >> pos.z;
-		getTile(pos)->load((*i));
+		std::string tiles;
+		*pTiles >> tiles;
+		loadTiles(tiles);
+	}
+	else
+	{
+		// older saves store every non-void tile as a map
+		for (YAML::Iterator i = node["tiles"].begin(); i != node["tiles"].end(); ++i)
+		{
+			Position pos;
+			(*i)["position"][0] >> pos.x;
+			(*i)["position"][1] >> pos.y;
+			(*i)["position"][2] >> pos.z;
+			getTile(pos)->load((*i));
+		}
 	}
 
 	for (YAML::Iterator i = node["nodes"].begin(); i != node["nodes"].end(); ++i)
@@ -120,6 +174,7 @@ void SavedBattleGame::load(const YAML::Node &node, Ruleset *rule, SavedGame* sav
 		_nodes.push_back(n);
 	}
 
+	std::map<int, BattleUnit*> unitsById;
 	for (YAML::Iterator i = node["units"].begin(); i != node["units"].end(); ++i)
 	{
 		UnitFaction faction;
@@ -145,6 +200,7 @@ void SavedBattleGame::load(const YAML::Node &node, Ruleset *rule, SavedGame* sav
 		}
 		b->load(*i);
 		_units.push_back(b);
+		unitsById[b->getId()] = b;
 		if (faction == FACTION_PLAYER)
 		{
 			if (b->getId() == selectedUnit)
@@ -175,6 +231,8 @@ void SavedBattleGame::load(const YAML::Node &node, Ruleset *rule, SavedGame* sav
 	// matches up tiles and units
 	resetUnitTiles();
 
+	std::map<int, BattleItem*> itemsById;
+	std::vector<std::pair<BattleItem*, int> > ammoIds;
 	for (YAML::Iterator i = node["items"].begin(); i != node["items"].end(); ++i)
 	{
 		std::string type;
@@ -189,13 +247,10 @@ void SavedBattleGame::load(const YAML::Node &node, Ruleset *rule, SavedGame* sav
 			(*i)["owner"] >> a;
 
 			// match up items and units
-			for (std::vector<BattleUnit*>::iterator bu = _units.begin(); bu != _units.end(); ++bu)
+			std::map<int, BattleUnit*>::iterator bu = unitsById.find(a);
+			if (bu != unitsById.end())
 			{
-				if ((*bu)->getId() == a)
-				{
-					item->moveToOwner(*bu);
-					break;
-				}
+				item->moveToOwner(bu->second);
 			}
 
 			// match up items and tiles
@@ -209,27 +264,88 @@ void SavedBattleGame::load(const YAML::Node &node, Ruleset *rule, SavedGame* sav
 					getTile(pos)->addItem(item);
 			}
 			_items.push_back(item);
+			itemsById[item->getId()] = item;
+
+			(*i)["ammoItem"] >> a;
+			if (a != -1)
+			{
+				ammoIds.push_back(std::make_pair(item, a));
+			}
 		}
 	}
 
-	// tie ammo items to their weapons, running through the items again
-	std::vector<BattleItem*>::iterator weaponi = _items.begin();
-	for (YAML::Iterator i = node["items"].begin(); i != node["items"].end(); ++i, ++weaponi)
+	// tie ammo items to their weapons, now that all items exist
+	for (std::vector<std::pair<BattleItem*, int> >::iterator i = ammoIds.begin(); i != ammoIds.end(); ++i)
 	{
-		(*i)["ammoItem"] >> a;
-		if (a != -1)
+		std::map<int, BattleItem*>::iterator ammo = itemsById.find(i->second);
+		if (ammo != itemsById.end())
 		{
-			for (std::vector<BattleItem*>::iterator ammoi = _items.begin(); ammoi != _items.end(); ++ammoi)
-			{
-				if ((*ammoi)->getId() == a)
-				{
-					(*weaponi)->setAmmoItem((*ammoi));
-					break;
-				}
-			}
+			i->first->setAmmoItem(ammo->second);
+		}
+	}
+
+}
+
+/**
+ * Loads the tiles from their compact encoding: a list of
+ * runs of identical consecutive tiles, each made of the
+ * run length followed by the tile values.
+ * @param data Encoded tiles.
+ */
+void SavedBattleGame::loadTiles(const std::string &data)
+{
+	std::istringstream ss(data);
+	int values[Tile::COMPACT_SIZE];
+	int tile = 0, total = _height * _length * _width;
+	int count;
+	while (tile < total && ss >> count)
+	{
+		for (int i = 0; i < Tile::COMPACT_SIZE; ++i)
+		{
+			ss >> values[i];
+		}
+		if (!ss)
+		{
+			throw Exception("Invalid tile data");
+		}
+		for (int end = std::min(tile + count, total); tile < end; ++tile)
+		{
+			_tiles[tile]->loadCompact(values);
 		}
 	}
+}
 
+/**
+ * Saves the tiles in their compact encoding, with
+ * every run of identical tiles on its own line.
+ * @return Encoded tiles.
+ */
+std::string SavedBattleGame::saveTiles() const
+{
+	std::ostringstream ss;
+	int values[Tile::COMPACT_SIZE], next[Tile::COMPACT_SIZE];
+	int total = _height * _length * _width;
+	int tile = 0;
+	while (tile < total)
+	{
+		_tiles[tile]->saveCompact(values);
+		int count = 1;
+		while (tile + count < total)
+		{
+			_tiles[tile + count]->saveCompact(next);
+			if (!std::equal(values, values + Tile::COMPACT_SIZE, next))
+				break;
+			count++;
+		}
+		ss << count;
+		for (int i = 0; i < Tile::COMPACT_SIZE; ++i)
+		{
+			ss << " " << values[i];
+		}
+		ss << "\n";
+		tile += count;
+	}
+	return ss.str();
 }
 
 /**
@@ -258,13 +374,11 @@ void SavedBattleGame::loadMapResources(ResourcePack *res)
 	}
 
 	initUtilities(res);
+	_nodeGraph->build();
 	getTileEngine()->calculateSunShading();
 	getTileEngine()->calculateTerrainLighting();
 	getTileEngine()->calculateUnitLighting();
-	for (std::vector<BattleUnit*>::iterator bu = _units.begin(); bu != _units.end(); ++bu)
-	{
-		_tileEngine->calculateFOV(*bu);
-	}
+	_tileEngine->calculateFOV(_units);
 }
 
 /**
@@ -291,16 +405,7 @@ void SavedBattleGame::save(YAML::Emitter &out) const
 	}
 	out << YAML::EndSeq;
 
-	out << YAML::Key << "tiles" << YAML::Value;
-	out << YAML::BeginSeq;
-	for (int i = 0; i < _height * _length * _width; ++i)
-	{
-		if (!_tiles[i]->isVoid())
-		{
-			_tiles[i]->save(out);
-		}
-	}
-	out << YAML::EndSeq;
+	out << YAML::Key << "tileData" << YAML::Value << YAML::Literal << saveTiles();
 
 	out << YAML::Key << "nodes" << YAML::Value;
 	out << YAML::BeginSeq;
@@ -368,6 +473,8 @@ void SavedBattleGame::initUtilities(ResourcePack *res)
 {
 	_pathfinding = new Pathfinding(this);
 	_tileEngine = new TileEngine(this, res->getVoxelData());
+	_threatMap = new ThreatMap(this);
+	_nodeGraph = new NodeGraph(this);
 }
 
 /**
@@ -652,6 +759,24 @@ TileEngine *const SavedBattleGame::getTileEngine() const
 	return _tileEngine;
 }
 
+/**
+ * Get the threat map, which tells how exposed each tile is.
+ * @return pointer to the threat map
+ */
+ThreatMap *const SavedBattleGame::getThreatMap() const
+{
+	return _threatMap;
+}
+
+/**
+ * Get the node graph, which indexes the nodes and knows the routes between them.
+ * @return pointer to the node graph
+ */
+NodeGraph *const SavedBattleGame::getNodeGraph() const
+{
+	return _nodeGraph;
+}
+
 /**
 * gets a pointer to the array of mapblock
 * @return pointer to the array of mapblocks
@@ -731,8 +856,8 @@ void SavedBattleGame::endTurn()
 		{
 			(*i)->prepareNewTurn();
 		}
-		_tileEngine->calculateFOV(*i);
 	}
+	_tileEngine->calculateFOV(_units);
 
 	if (_side != FACTION_PLAYER)
 		selectNextPlayerUnit();
@@ -859,10 +984,11 @@ Node *SavedBattleGame::getSpawnNode(int nodeRank, BattleUnit *unit)
 	int highestPriority = -1;
 	std::vector<Node*> compliantNodes;	
 
-	for (std::vector<Node*>::iterator i = getNodes()->begin(); i != getNodes()->end(); ++i)
+	const std::vector<Node*> &nodes = _nodeGraph->getNodes(nodeRank); // ranks must match
+
+	for (std::vector<Node*>::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
 	{
-		if ((*i)->getRank() == nodeRank										// ranks must match
-			&& (!((*i)->getType() & Node::TYPE_SMALL) 
+		if ((!((*i)->getType() & Node::TYPE_SMALL) 
 				|| unit->getArmor()->getSize() == 1)				// the small unit bit is not set or the unit is small
 			&& (!((*i)->getType() & Node::TYPE_FLYING) 
 				|| unit->getArmor()->getMovementType() == MT_FLY)// the flying unit bit is not set or the unit can fly
@@ -883,7 +1009,7 @@ Node *SavedBattleGame::getSpawnNode(int nodeRank, BattleUnit *unit)
 	
 	if (compliantNodes.empty()) return 0;
 
-	int n = RNG::generate(0, compliantNodes.size() - 1);
+	int n = RNG::generate(RNG::STREAM_MAPGEN, 0, compliantNodes.size() - 1);
 
 	return compliantNodes[n];
 }
@@ -918,7 +1044,7 @@ Node *SavedBattleGame::getPatrolNode(bool scout, BattleUnit *unit, Node *fromNod
 
 	if (compliantNodes.empty()) return 0;
 
-	return compliantNodes[RNG::generate(0, compliantNodes.size() - 1)];
+	return compliantNodes[RNG::generate(RNG::STREAM_AI, 0, compliantNodes.size() - 1)];
 }
 
 /**
@@ -931,21 +1057,15 @@ void SavedBattleGame::prepareNewTurn()
 	std::vector<Tile*> tilesOnSmoke;
 
 	// prepare a list of tiles on fire/smoke
-	for (int i = 0; i < getWidth() * getLength() * getHeight(); ++i)
-	{
-		if (getTiles()[i]->getFire() > 0)
-		{
-			tilesOnFire.push_back(getTiles()[i]);
-		}
-		if (getTiles()[i]->getSmoke() > 0)
-		{
-			tilesOnSmoke.push_back(getTiles()[i]);
-		}
-	}
+	const int size = getWidth() * getLength() * getHeight();
+	const int grain = 1024;
+	BurningTileTask task(getTiles(), JobSystem::getChunks(0, size, grain));
+	JobSystem::parallelFor(0, size, grain, &task);
+	task.getTiles(&tilesOnFire, &tilesOnSmoke);
 
 	// smoke spreads in 1 random direction, but the direction is same for all smoke
-	int spreadX = RNG::generate(-1, +1);
-	int spreadY = RNG::generate(-1, +1);
+	int spreadX = RNG::generate(RNG::STREAM_COMBAT, -1, +1);
+	int spreadY = RNG::generate(RNG::STREAM_COMBAT, -1, +1);
 	for (std::vector<Tile*>::iterator i = tilesOnSmoke.begin(); i != tilesOnSmoke.end(); ++i)
 	{
 		int x = (*i)->getPosition().x;
@@ -984,11 +1104,11 @@ void SavedBattleGame::prepareNewTurn()
 		if ((*i)->getUnit())
 		{
 			// units on a flaming tile suffer damage
-			(*i)->getUnit()->damage(Position(0,0,0), RNG::generate(1,12), DT_IN, true);
+			(*i)->getUnit()->damage(Position(0,0,0), RNG::generate(RNG::STREAM_COMBAT, 1,12), DT_IN, true);
 			// units on a flaming tile can catch fire 33% chance
-			if (RNG::generate(0,2) == 1)
+			if (RNG::generate(RNG::STREAM_COMBAT, 0,2) == 1)
 			{
-				(*i)->getUnit()->setFire(RNG::generate(1,5));
+				(*i)->getUnit()->setFire(RNG::generate(RNG::STREAM_COMBAT, 1,5));
 			}
 		}
 
@@ -1006,12 +1126,12 @@ void SavedBattleGame::prepareNewTurn()
 						int flam = t->getFlammability();
 						if (flam < 255)
 						{
-							double base = RNG::boxMuller(0,126);
+							double base = RNG::boxMuller(RNG::STREAM_COMBAT, 0,126);
 							if (base < 0) base *= -1;
 
 							if (flam < base)
 							{
-								if (RNG::generate(0, flam) < 2)
+								if (RNG::generate(RNG::STREAM_COMBAT, 0, flam) < 2)
 								{
 									t->ignite();
 								}
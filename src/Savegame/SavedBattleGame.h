@@ -42,6 +42,8 @@ class Soldier;
 class Position;
 class Pathfinding;
 class TileEngine;
+class ThreatMap;
+class NodeGraph;
 class BattleItem;
 class Item;
 class RuleInventory;
@@ -64,6 +66,8 @@ private:
 	std::vector<BattleItem*> _items;
 	Pathfinding *_pathfinding;
 	TileEngine *_tileEngine;
+	ThreatMap *_threatMap;
+	NodeGraph *_nodeGraph;
 	std::string _missionType;
 	int _globalShade;
 	UnitFaction _side;
@@ -71,6 +75,11 @@ private:
 	bool _debugMode;
 	bool _aborted;
 	int _itemId;
+
+	/// Loads the tiles from their compact encoding.
+	void loadTiles(const std::string &data);
+	/// Saves the tiles to their compact encoding.
+	std::string saveTiles() const;
 public:
 	/// Creates a new battle save, based on current generic save.
 	SavedBattleGame();
@@ -130,6 +139,10 @@ public:
 	Pathfinding *const getPathfinding() const;
 	/// get a pointer to the tileengine
 	TileEngine *const getTileEngine() const;
+	/// get a pointer to the threat map
+	ThreatMap *const getThreatMap() const;
+	/// get a pointer to the node graph
+	NodeGraph *const getNodeGraph() const;
 	/// get the playing side
 	UnitFaction getSide() const;
 	/// get the turn number
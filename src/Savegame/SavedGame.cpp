@@ -28,6 +28,7 @@
 #include "../Engine/Exception.h"
 #include "../Engine/Options.h"
 #include "../Engine/CrossPlatform.h"
+#include "../Engine/IdTable.h"
 #include "SavedBattleGame.h"
 #include "GameTime.h"
 #include "Country.h"
@@ -86,7 +87,6 @@ bool equalProduction::operator()(const Production * p) const
  */
 SavedGame::SavedGame(GameDifficulty difficulty) : _difficulty(difficulty), _funds(0), _countries(), _regions(), _bases(), _ufos(), _craftId(), _waypoints(), _ufoId(1), _waypointId(1), _soldierId(1), _battleGame(0)
 {
-	RNG::init();
 	_time = new GameTime(6, 1, 1, 1999, 12, 0, 0);
 	_ufopaedia = new UfopaediaSaved();
 }
@@ -202,6 +202,10 @@ void SavedGame::load(const std::string &filename, Ruleset *rule)
 	int a = 0;
 	doc["difficulty"] >> a;
 	_difficulty = (GameDifficulty)a;
+	if (const YAML::Node *pName = doc.FindValue("rng"))
+	{
+		RNG::load(*pName);
+	}
 	doc["funds"] >> _funds;
 
 	for (YAML::Iterator i = doc["countries"].begin(); i != doc["countries"].end(); ++i)
@@ -255,7 +259,7 @@ void SavedGame::load(const std::string &filename, Ruleset *rule)
 	{
 		std::string research;
 		*it >> research;
-		_discovered.push_back(rule->getResearchProject(research));
+		discoverResearch(rule->getResearchProject(research));
 	}
 
 	if (const YAML::Node *pName = doc.FindValue("battleGame"))
@@ -285,7 +289,17 @@ void SavedGame::save(const std::string &filename) const
 	}
 
 	YAML::Emitter out;
+	save(out);
+	sav << out.c_str();
+	sav.close();
+}
 
+/**
+ * Saves a saved game's contents to YAML.
+ * @param out YAML emitter.
+ */
+void SavedGame::save(YAML::Emitter &out) const
+{
 	// Saves the brief game info used in the saves list
 	out << YAML::BeginDoc;
 	out << YAML::BeginMap;
@@ -298,6 +312,8 @@ void SavedGame::save(const std::string &filename) const
 	out << YAML::BeginDoc;
 	out << YAML::BeginMap;
 	out << YAML::Key << "difficulty" << YAML::Value << _difficulty;
+	out << YAML::Key << "rng" << YAML::Value;
+	RNG::save(out);
 	out << YAML::Key << "funds" << YAML::Value << _funds;
 	out << YAML::Key << "countries" << YAML::Value;
 	out << YAML::BeginSeq;
@@ -353,8 +369,26 @@ void SavedGame::save(const std::string &filename) const
 	out << YAML::Key << "ufopaedia" << YAML::Value;
 	_ufopaedia->save(out);
 	out << YAML::EndMap;
-	sav << out.c_str();
-	sav.close();
+}
+
+/**
+ * Returns a checksum of everything that goes in the save,
+ * used to check if two sessions ended up in the same state.
+ * @return Hexadecimal digest.
+ */
+std::string SavedGame::getDigest() const
+{
+	YAML::Emitter out;
+	save(out);
+	unsigned int hash = 2166136261u;
+	for (const char *c = out.c_str(); *c != 0; ++c)
+	{
+		hash ^= (unsigned char)*c;
+		hash *= 16777619u;
+	}
+	std::stringstream ss;
+	ss << std::hex << std::setw(8) << std::setfill('0') << hash;
+	return ss.str();
 }
 
 /**
@@ -521,13 +555,49 @@ UfopaediaSaved *SavedGame::getUfopaedia()
 	return _ufopaedia;
 }
 
+/**
+ * Add a ResearchProject to the list of already discovered ResearchProject,
+ * and update the research state of the projects depending on it.
+ * @param r The newly found ResearchProject
+ * @return true if the ResearchProject wasn't discovered already
+*/
+bool SavedGame::discoverResearch (const RuleResearchProject * r)
+{
+	size_t handle = r->getHandle();
+	if (handle < _researched.size() && _researched[handle])
+	{
+		return false;
+	}
+	size_t size = IdTable::size();
+	if (_researched.size() < size)
+	{
+		_researched.resize(size, false);
+		_unlocked.resize(size, false);
+		_metDependencys.resize(size, 0);
+	}
+	_discovered.push_back(r);
+	_researched[handle] = true;
+	for(std::vector<RuleResearchProject *>::const_iterator it = r->getRequiredBy().begin (); it != r->getRequiredBy().end (); ++it)
+	{
+		_metDependencys[(*it)->getHandle()]++;
+	}
+	for(std::vector<RuleResearchProject *>::const_iterator it = r->getUnlocked().begin (); it != r->getUnlocked().end (); ++it)
+	{
+		_unlocked[(*it)->getHandle()] = true;
+	}
+	return true;
+}
+
 /**
  * Add a ResearchProject to the list of already discovered ResearchProject
  * @param r The newly found ResearchProject
 */
 void SavedGame::addFinishedResearch (const RuleResearchProject * r, Ruleset * ruleset)
 {
-	_discovered.push_back(r);
+	if (!discoverResearch(r))
+	{
+		return;
+	}
 	if(ruleset)
 	{
 		std::vector<RuleResearchProject*> availableResearch;
@@ -562,37 +632,13 @@ const std::vector<const RuleResearchProject *> & SavedGame::getDiscoveredResearc
 */
 void SavedGame::getAvailableResearchProjects (std::vector<RuleResearchProject *> & projects, Ruleset * ruleset, Base * base) const
 {
-	const std::vector<const RuleResearchProject *> & discovereds(getDiscoveredResearchs());
 	const std::map<std::string, RuleResearchProject *> & researchProjects = ruleset->getResearchProjects();
-	const std::vector<ResearchProject *> & baseResearchProjects = base->getResearch();
-	std::vector<const RuleResearchProject *> unlockeds;
-	for(std::vector<const RuleResearchProject *>::const_iterator it = discovereds.begin (); it != discovereds.end (); ++it)
-	{
-		for(std::vector<RuleResearchProject *>::const_iterator itUnlocked = (*it)->getUnlocked ().begin (); itUnlocked != (*it)->getUnlocked ().end (); ++itUnlocked)
-		{
-			unlockeds.push_back(*itUnlocked);
-		}
-	}
 	for(std::map<std::string, RuleResearchProject *>::const_iterator iter = researchProjects.begin (); iter != researchProjects.end (); ++iter)
 	{
-		if (!isResearchAvailable(iter->second, unlockeds))
-		{
-			continue;
-		}
-		std::vector<const RuleResearchProject *>::const_iterator itDiscovered = std::find(discovereds.begin (), discovereds.end (), iter->second);
-		if (itDiscovered != discovereds.end ())
-		{
-			continue;
-		}
-		if (std::find_if (baseResearchProjects.begin(), baseResearchProjects.end (), findRuleResearchProject(iter->second)) != baseResearchProjects.end ())
+		if (isResearchAvailable(iter->second, base))
 		{
-			continue;
+			projects.push_back (iter->second);
 		}
-		if (iter->second->needItem() && base->getItems()->getItem(iter->second->getName ()) == 0)
-		{
-			continue;
-		}
-		projects.push_back (iter->second);
 	}
 }
 
@@ -604,7 +650,6 @@ void SavedGame::getAvailableResearchProjects (std::vector<RuleResearchProject *>
 */
 void SavedGame::getAvailableProductions (std::vector<RuleManufactureInfo *> & productions, Ruleset * ruleset, Base * base) const
 {
-	const std::vector<const RuleResearchProject *> & discovereds(getDiscoveredResearchs());
 	const std::map<std::string, RuleManufactureInfo *> & items (ruleset->getManufactureProjects ());
 	const std::vector<Production *> baseProductions (base->getProductions ());
 
@@ -612,7 +657,7 @@ void SavedGame::getAvailableProductions (std::vector<RuleManufactureInfo *> & pr
 		iter != items.end ();
 		++iter)
 	{
-		if(std::find(discovereds.begin (), discovereds.end (), ruleset->getResearchProject(iter->first)) == discovereds.end ())
+		if(!isResearched(iter->first))
 		{
 		 	continue;
 		}
@@ -625,30 +670,49 @@ void SavedGame::getAvailableProductions (std::vector<RuleManufactureInfo *> & pr
 }
 
 /**
-   Check whether a ResearchProject can be researched.
+   Check whether a ResearchProject can be researched, either because
+   all its dependencies have been discovered or because it was unlocked.
    * @param r the RuleResearchProject to test.
-   * @param unlockeds the list of currently unlocked RuleResearchProject
    * @return true if the RuleResearchProject can be researched
 */
-bool SavedGame::isResearchAvailable (RuleResearchProject * r, const std::vector<const RuleResearchProject *> & unlockeds) const
+bool SavedGame::isResearchAvailable (const RuleResearchProject * r) const
 {
-	std::vector<RuleResearchProject *>::const_iterator iter = r->getDependencys().begin ();
-	const std::vector<const RuleResearchProject *> & discovereds(getDiscoveredResearchs());
-	if(std::find(unlockeds.begin (), unlockeds.end (),
-			 r) != unlockeds.end ())
+	size_t handle = r->getHandle();
+	if (handle >= _researched.size())
 	{
-		return true;
+		return r->getDependencys().empty();
+	}
+	return _unlocked[handle] || _metDependencys[handle] == (int)r->getDependencys().size();
+}
+
+/**
+   Check whether a ResearchProject can be started in a Base:
+   it must be available, not discovered yet, not already
+   in progress and have its item in the base if needed.
+   * @param r the RuleResearchProject to test.
+   * @param base a pointer to a Base
+   * @return true if the RuleResearchProject can be researched in the Base
+*/
+bool SavedGame::isResearchAvailable (const RuleResearchProject * r, Base * base) const
+{
+	if (!isResearchAvailable(r))
+	{
+		return false;
 	}
-	while (iter != r->getDependencys().end ())
+	size_t handle = r->getHandle();
+	if (handle < _researched.size() && _researched[handle])
 	{
-		std::vector<const RuleResearchProject *>::const_iterator itDiscovered = std::find(discovereds.begin (), discovereds.end (), *iter);
-		if (itDiscovered == discovereds.end ())
-		{
-			return false;
-		}
-		++iter;
+		return false;
+	}
+	const std::vector<ResearchProject *> & baseResearchProjects = base->getResearch();
+	if (std::find_if (baseResearchProjects.begin(), baseResearchProjects.end (), findRuleResearchProject(const_cast<RuleResearchProject *>(r))) != baseResearchProjects.end ())
+	{
+		return false;
+	}
+	if (r->needItem() && base->getItems()->getItem(r->getName ()) == 0)
+	{
+		return false;
 	}
-
 	return true;
 }
 
@@ -662,20 +726,26 @@ bool SavedGame::isResearchAvailable (RuleResearchProject * r, const std::vector<
 void SavedGame::getDependableResearch (std::vector<RuleResearchProject *> & dependables, const RuleResearchProject *research, Ruleset * ruleset, Base * base) const
 {
 	getDependableResearchBasic(dependables, research, ruleset, base);
-	for(std::vector<const RuleResearchProject *>::const_iterator iter = _discovered.begin (); iter != _discovered.end (); ++iter)
+	for(std::vector<RuleResearchProject *>::const_iterator iter = research->getRequiredBy().begin (); iter != research->getRequiredBy().end (); ++iter)
 	{
-		if((*iter)->getCost() == 0)
+		if((*iter)->getCost() == 0 && isResearched((*iter)->getName ()))
 		{
-			if (std::find((*iter)->getDependencys().begin (), (*iter)->getDependencys().end (), research) != (*iter)->getDependencys().end ())
-			{
-				getDependableResearchBasic(dependables, *iter, ruleset, base);
-			}
+			getDependableResearchBasic(dependables, *iter, ruleset, base);
 		}
 	}
 }
 
+/**
+ * Sorts research projects by name, same as the ruleset.
+ */
+static bool compareResearchName(const RuleResearchProject *a, const RuleResearchProject *b)
+{
+	return a->getName() < b->getName();
+}
+
 /**
    Get the list of newly available research projects once a ResearchProject has been completed. This function doesn't check for fake ResearchProject.
+   Only the projects linked to the discovered one need to be checked.
    * @param dependables the list of RuleResearchProject which are now available.
    * @param research The RuleResearchProject which has just been discovered
    * @param ruleset the Game Ruleset
@@ -683,23 +753,20 @@ void SavedGame::getDependableResearch (std::vector<RuleResearchProject *> & depe
 */
 void SavedGame::getDependableResearchBasic (std::vector<RuleResearchProject *> & dependables, const RuleResearchProject *research, Ruleset * ruleset, Base * base) const
 {
-	std::vector<RuleResearchProject *> possibleProjects;
-	getAvailableResearchProjects(possibleProjects, ruleset, base);
+	std::vector<RuleResearchProject *> possibleProjects(research->getRequiredBy());
+	possibleProjects.insert(possibleProjects.end(), research->getUnlockedBy().begin(), research->getUnlockedBy().end());
+	std::sort(possibleProjects.begin(), possibleProjects.end(), compareResearchName);
+	possibleProjects.erase(std::unique(possibleProjects.begin(), possibleProjects.end()), possibleProjects.end());
 	for(std::vector<RuleResearchProject *>::iterator iter = possibleProjects.begin (); iter != possibleProjects.end (); ++iter)
 	{
-		if (std::find((*iter)->getDependencys().begin (), (*iter)->getDependencys().end (), research) != (*iter)->getDependencys().end ()
-			||
-			std::find((*iter)->getUnlocked().begin (), (*iter)->getUnlocked().end (), research) != (*iter)->getUnlocked().end ()
-			)
+		if (!isResearchAvailable(*iter, base))
 		{
-				dependables.push_back(*iter);
-			if ((*iter)->getCost() == 0)
-			{
-				getDependableResearchBasic(dependables, *iter, ruleset, base);
-			}
-			else
-			{
-			}
+			continue;
+		}
+		dependables.push_back(*iter);
+		if ((*iter)->getCost() == 0)
+		{
+			getDependableResearchBasic(dependables, *iter, ruleset, base);
 		}
 	}
 }
@@ -713,13 +780,8 @@ bool SavedGame::isResearched(const std::string &research) const
 {
 	if (research.empty())
 		return true;
-	for (std::vector<const RuleResearchProject *>::const_iterator i = _discovered.begin(); i != _discovered.end(); ++i)
-	{
-		if ((*i)->getName() == research)
-			return true;
-	}
-
-	return false;
+	int handle = IdTable::find(research);
+	return (handle >= 0 && (size_t)handle < _researched.size() && _researched[handle]);
 }
 
 /**
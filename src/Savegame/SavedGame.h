@@ -22,6 +22,7 @@
 #include <map>
 #include <vector>
 #include <string>
+#include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
 {
@@ -68,9 +69,15 @@ private:
 	SavedBattleGame *_battleGame;
 	UfopaediaSaved *_ufopaedia;
 	std::vector<const RuleResearchProject *> _discovered;
+	std::vector<bool> _researched, _unlocked;
+	std::vector<int> _metDependencys;
 
+	/// Mark a ResearchProject as discovered
+	bool discoverResearch (const RuleResearchProject * r);
 	/// Check whether a ResearchProject can be researched
-	bool isResearchAvailable (RuleResearchProject * r, const std::vector<const RuleResearchProject *> & unlockeds) const;
+	bool isResearchAvailable (const RuleResearchProject * r) const;
+	/// Check whether a ResearchProject can be started in a Base
+	bool isResearchAvailable (const RuleResearchProject * r, Base * base) const;
 	void getDependableResearchBasic (std::vector<RuleResearchProject *> & dependables, const RuleResearchProject *research, Ruleset * ruleset, Base * base) const;
 public:
 	/// Creates a new save with a certain difficulty.
@@ -83,6 +90,10 @@ public:
 	void load(const std::string &filename, Ruleset *rule);
 	/// Saves a saved game to YAML.
 	void save(const std::string &filename) const;
+	/// Saves a saved game to a YAML emitter.
+	void save(YAML::Emitter &out) const;
+	/// Gets a checksum of the saved game.
+	std::string getDigest() const;
 	/// Gets the current funds.
 	int getFunds() const;
 	/// Sets new funds.
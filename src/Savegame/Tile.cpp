@@ -34,7 +34,7 @@ namespace OpenXcom
 * constructor
 * @param pos Position.
 */
-Tile::Tile(const Position& pos): _smoke(0), _fire(0),  _explosive(0), _pos(pos), _unit(0), _animationOffset(0), _markerColor(0), _visible(false)
+Tile::Tile(const Position& pos): _smoke(0), _fire(0),  _explosive(0), _destroyed(0), _pos(pos), _unit(0), _animationOffset(0), _markerColor(0), _visible(false)
 {
 	for (int i = 0; i < 4; ++i)
 	{
@@ -100,6 +100,46 @@ void Tile::save(YAML::Emitter &out) const
 	out << YAML::EndMap;
 }
 
+/**
+ * Loads the tile from the values of the compact encoding
+ * used by battle saves: map data IDs, map data set IDs,
+ * smoke, fire and discovered flags.
+ * @param values Array of COMPACT_SIZE values.
+ */
+void Tile::loadCompact(const int *values)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		_mapDataID[i] = values[i];
+		_mapDataSetID[i] = values[4 + i];
+	}
+	_smoke = values[8];
+	_fire = values[9];
+	for (int i = 0; i < 3; i++)
+	{
+		_discovered[i] = values[10 + i] != 0;
+	}
+}
+
+/**
+ * Saves the tile to the values of the compact encoding.
+ * @param values Array of COMPACT_SIZE values.
+ */
+void Tile::saveCompact(int *values) const
+{
+	for (int i = 0; i < 4; i++)
+	{
+		values[i] = _mapDataID[i];
+		values[4 + i] = _mapDataSetID[i];
+	}
+	values[8] = _smoke;
+	values[9] = _fire;
+	for (int i = 0; i < 3; i++)
+	{
+		values[10 + i] = _discovered[i] ? 1 : 0;
+	}
+}
+
 /**
  * Get the MapData pointer of a part of the tile.
  * @param part the part 0-3.
@@ -372,6 +412,7 @@ void Tile::destroy(int part)
 	{
 		MapData *originalPart = _objects[part];
 		int originalMapDataSetID = _mapDataSetID[part];
+		_destroyed++;
 		setMapData(0, -1, -1, part);
 		if (originalPart->getDieMCD())
 		{
@@ -398,6 +439,16 @@ void Tile::damage(int part, int power)
 		destroy(part);
 }
 
+/**
+ * Get the number of parts destroyed on this tile so far. It only ever
+ * goes up, so anything that depends on the terrain can tell it changed.
+ * @return number of destroyed parts
+ */
+int Tile::getDestroyed() const
+{
+	return _destroyed;
+}
+
 
 /**
  * Set a "virtual" explosive on this tile. We mark a tile this way to detonate it later.
@@ -455,7 +506,7 @@ void Tile::detonate()
 		int flam = getFlammability();
 		if (flam <= 20)
 		{
-			if (RNG::generate(0, 20) - flam >= 0)
+			if (RNG::generate(RNG::STREAM_COMBAT, 0, 20) - flam >= 0)
 			{
 				ignite();
 			}
@@ -577,7 +628,7 @@ BattleUnit *Tile::getUnit() const
 void Tile::setFire(int fire)
 {
 	_fire = fire;
-	_animationOffset = RNG::generate(0,3);
+	_animationOffset = RNG::generate(RNG::STREAM_COSMETIC, 0,3);
 }
 
 /**
@@ -597,7 +648,7 @@ void Tile::addSmoke(int smoke)
 {
 	_smoke += smoke;
 	if (_smoke > 40) _smoke = 40;
-	_animationOffset = RNG::generate(0,3);
+	_animationOffset = RNG::generate(RNG::STREAM_COSMETIC, 0,3);
 }
 
 /**
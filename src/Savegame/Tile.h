@@ -51,6 +51,7 @@ protected:
 	int _smoke;
 	int _fire;
 	int _explosive;
+	int _destroyed;
 	Position _pos;
 	BattleUnit *_unit;
 	std::vector<BattleItem *> _inventory;
@@ -58,6 +59,8 @@ protected:
 	int _markerColor;
 	int _visible;
 public:
+	/// Number of values in the compact tile encoding.
+	static const int COMPACT_SIZE = 13;
 	/// Creates a tile.
 	Tile(const Position& pos);
 	/// Cleans up a tile.
@@ -66,6 +69,10 @@ public:
 	void load(const YAML::Node &node);
 	/// Saves the tile to yaml
 	void save(YAML::Emitter &out) const;
+	/// Loads the tile from its compact encoding.
+	void loadCompact(const int *values);
+	/// Saves the tile to its compact encoding.
+	void saveCompact(int *values) const;
 	/// Gets a pointer to the mapdata for a specific part of the tile.
 	MapData *getMapData(int part) const;
 	/// Sets the pointer to the mapdata for a specific part of the tile
@@ -106,6 +113,8 @@ public:
 	void destroy(int part);
 	/// Damage a tile part.
 	void damage(int part, int power);
+	/// Get the number of parts destroyed on this tile so far.
+	int getDestroyed() const;
 	/// Set a "virtual" explosive on this tile, to detonate later.
 	void setExplosive(int power);
 	/// Get explosive power of this tile.
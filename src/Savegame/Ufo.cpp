@@ -245,6 +245,15 @@ bool Ufo::isDestroyed() const
 void Ufo::calculateSpeed()
 {
 	MovingTarget::calculateSpeed();
+	calculateDirection();
+}
+
+/**
+ * Updates the direction for the UFO based
+ * on the current heading along its path.
+ */
+void Ufo::calculateDirection()
+{
 	if (_speedLon > 0)
 	{
 		if (_speedLat > 0)
@@ -296,6 +305,7 @@ void Ufo::think()
 	if (!isCrashed())
 	{
 		move();
+		calculateDirection();
 		if (reachedDestination())
 		{
 			setSpeed(0);
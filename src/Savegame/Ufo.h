@@ -46,6 +46,8 @@ private:
 
 	/// Calculates a new speed vector to the destination.
 	void calculateSpeed();
+	/// Updates the UFO's direction from its speed vector.
+	void calculateDirection();
 public:
 	/// Creates a UFO of the specified type.
 	Ufo(RuleUfo *rules);
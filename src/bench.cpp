@@ -0,0 +1,112 @@
+/*
+ * Copyright 2010-2012 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <exception>
+#include <SDL.h>
+#include "Engine/Game.h"
+#include "Engine/Options.h"
+#include "Engine/RNG.h"
+#include "Engine/JobSystem.h"
+#include "Resource/XcomResourcePack.h"
+#include "Battlescape/BattleSimulator.h"
+
+/**
+ * Battlescape benchmark: plays out a battle with the AI on both
+ * sides and no graphics or sound, then prints how long each part
+ * of the engine took.
+ *
+ * Usage: openxcom-bench [-save name] [-turns n] [-seed n] [OpenXcom options]
+ * Without a save, a terror mission is generated from the starting base.
+ * A save brings its own random state, so it can't be given a seed.
+ */
+
+using namespace OpenXcom;
+
+int main(int argc, char** args)
+{
+	std::string save = "";
+	int turns = 10;
+	int seed = 0;
+	bool seeded = false;
+	for (int i = 1; i < argc - 1; ++i)
+	{
+		std::string arg = args[i];
+		if (arg == "-save")
+		{
+			save = args[++i];
+		}
+		else if (arg == "-turns")
+		{
+			std::istringstream(args[++i]) >> turns;
+		}
+		else if (arg == "-seed")
+		{
+			std::istringstream(args[++i]) >> seed;
+			seeded = true;
+		}
+	}
+	if (seeded && !save.empty())
+	{
+		std::cerr << "ERROR: -seed can't be used with -save, the save has its own random state" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// Run with no window or sound device
+	SDL_putenv((char*)"SDL_VIDEODRIVER=dummy");
+	SDL_putenv((char*)"SDL_AUDIODRIVER=dummy");
+
+	Game *game = 0;
+	try
+	{
+		Options::init(argc, args);
+		Options::setBool("mute", true);
+		game = new Game("OpenXcom Benchmark", 320, 200, 8);
+		game->setResourcePack(new XcomResourcePack());
+		std::string language = Options::getString("language");
+		game->loadLanguage((language == "" || language == "~") ? "English" : language);
+
+		// a save brings its own generator state
+		RNG::init(seed);
+		JobSystem::init(Options::getInt("jobThreads"));
+		BattleSimulator sim(game);
+		if (save.empty())
+		{
+			sim.generate();
+		}
+		else
+		{
+			sim.load(save);
+		}
+		sim.run(turns);
+		sim.report(std::cout);
+	}
+	catch (std::exception &e)
+	{
+		std::cerr << "ERROR: " << e.what() << std::endl;
+		JobSystem::quit();
+		delete game;
+		return EXIT_FAILURE;
+	}
+
+	JobSystem::quit();
+	delete game;
+	return EXIT_SUCCESS;
+}
@@ -17,10 +17,18 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
 #include "Engine/CrossPlatform.h"
 #include "Engine/Game.h"
 #include "Engine/Screen.h"
 #include "Engine/Options.h"
+#include "Engine/RNG.h"
+#include "Engine/InputLog.h"
+#include "Engine/JobSystem.h"
+#include "Savegame/SavedGame.h"
 #include "Menu/StartState.h"
 
 /** @mainpage
@@ -44,17 +52,71 @@ Game *game = 0;
 // programming license revoked...
 int main(int argc, char** args)
 {
+	// -record <file> logs the session, -replay <file> plays one back
+	std::string record = "", replay = "";
+	for (int i = 1; i < argc - 1; ++i)
+	{
+		std::string arg = args[i];
+		if (arg == "-record")
+			record = args[i+1];
+		else if (arg == "-replay")
+			replay = args[i+1];
+	}
+	bool match = true;
+
 #ifndef _DEBUG
 	try
 	{
 #endif
 		Options::init(argc, args);
+		if (!replay.empty())
+		{
+			// play back without a window or sound device
+			InputLog::replay(replay);
+			// and in an empty user folder of its own, so saves made during the
+			// replay don't overwrite the player's and local saves can't change the outcome
+			std::string folder = CrossPlatform::endPath(Options::getUserFolder() + "replay");
+			CrossPlatform::createFolder(folder);
+			std::vector<std::string> saves = CrossPlatform::getFolderContents(folder, "sav");
+			for (std::vector<std::string>::iterator i = saves.begin(); i != saves.end(); ++i)
+			{
+				remove((folder + *i).c_str());
+			}
+			Options::setUserFolder(folder);
+			Options::setBool("fullscreen", false);
+			Options::setBool("mute", true);
+			SDL_putenv((char*)"SDL_VIDEODRIVER=dummy");
+			SDL_putenv((char*)"SDL_AUDIODRIVER=dummy");
+		}
+		else if (!record.empty())
+		{
+			InputLog::record(record);
+		}
+		RNG::init();
+		JobSystem::init(Options::getInt("jobThreads"));
 		game = new Game("OpenXcom " + Options::getVersion(), 320, 200, 8);
 		game->getScreen()->setFullscreen(Options::getBool("fullscreen"));
 		game->getScreen()->setResolution(Options::getInt("displayWidth"), Options::getInt("displayHeight"));
 		game->setVolume(Options::getInt("soundVolume"), Options::getInt("musicVolume"));
 		game->setState(new StartState(game));
+		Uint32 start = SDL_GetTicks();
 		game->run();
+		if (!record.empty() || !replay.empty())
+		{
+			int frames = InputLog::getFrame();
+			std::string digest = game->getSavedGame() ? game->getSavedGame()->getDigest() : "";
+			match = InputLog::finish(digest);
+			if (digest.empty())
+			{
+				std::cerr << "No game was running, the session can't be checked" << std::endl;
+			}
+			if (!replay.empty())
+			{
+				std::cout << "Frames: " << frames << std::endl;
+				std::cout << "Time: " << (SDL_GetTicks() - start) / 1000.0 << " s" << std::endl;
+				std::cout << "Digest: " << digest << (match ? " (match)" : " (MISMATCH)") << std::endl;
+			}
+		}
 #ifndef _DEBUG
 	}
 	catch (std::exception &e)
@@ -63,9 +125,15 @@ int main(int argc, char** args)
 		exit(EXIT_FAILURE);
 	}
 #endif
-	Options::save();
+	// replays run with the recorded options, don't keep them
+	if (replay.empty())
+	{
+		Options::save();
+	}
+
+	JobSystem::quit();
 
 	// Comment this for faster exit.
 	delete game;
-	return EXIT_SUCCESS;
+	return match ? EXIT_SUCCESS : EXIT_FAILURE;
 }